@@ -0,0 +1,50 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_ACCESSMODECOMPARISON_H
+#define CPTUTORIALEXAMPLE_ACCESSMODECOMPARISON_H
+
+// System includes
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+#include "xAODRootAccess/TEvent.h"
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct JobConfig;
+
+  /// Outcome of running the job in one TEvent access mode
+  struct AccessModeResult {
+    AccessModeResult();
+
+    /// The access mode used
+    xAOD::TEvent::EAuxMode mode;
+    /// Number of events processed
+    Long64_t nEvents;
+    /// Wall-clock time of the event loop [s]
+    double wallTime;
+    /// Resident memory of the job's process before and after the job [MB]
+    double rssBefore, rssAfter;
+    /// Peak resident memory of the job's process [MB]
+    double peakRss;
+  }; // struct AccessModeResult
+
+  /// Run the job once in each TEvent access mode and print a comparison
+  ///
+  /// All runs use the same input and settings, apart from the access
+  /// mode. Each of them runs in a process forked for it, so the memory
+  /// numbers are the growth of the resident memory during the run and
+  /// the peak resident memory of its process, not affected by the runs
+  /// before it. The first run still pays for bringing the input into the
+  /// operating system's page cache.
+  ///
+  StatusCode compareAccessModes(const JobConfig& config,
+                                std::vector<AccessModeResult>* results = 0);
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_ACCESSMODECOMPARISON_H
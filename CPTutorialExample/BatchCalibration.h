@@ -0,0 +1,170 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_BATCHCALIBRATION_H
+#define CPTUTORIALEXAMPLE_BATCHCALIBRATION_H
+
+// System includes
+#include <string>
+#include <vector>
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// EDM includes
+#include "AthContainers/AuxElement.h"
+#include "AthContainers/OwnershipPolicy.h"
+
+namespace CPTutorial {
+
+  /// Input variables of a batch of objects in contiguous arrays
+  ///
+  /// The batch holds one float column per variable, filled from the aux
+  /// store of whole containers. Several containers, e.g. the jets of a
+  /// block of events, can be gathered one after the other; gather()
+  /// returns the offset of each container's first object, which is what
+  /// scatter() needs to write the results back.
+  ///
+  class ObjectBatch {
+
+  public:
+    /// Constructor with the names of the (float) variables to gather
+    explicit ObjectBatch(const std::vector<std::string>& variables);
+
+    /// Append the objects of a container, returning the offset of the
+    /// first one
+    template<class CONT>
+    std::size_t gather(const CONT& objects);
+    /// Remove all objects, keeping the allocated memory
+    void clear();
+
+    /// Number of objects in the batch
+    std::size_t size() const { return m_size; }
+    /// Number of variables
+    std::size_t nVariables() const { return m_columns.size(); }
+    /// Index of a variable, npos if it isn't gathered
+    std::size_t index(const std::string& variable) const;
+    /// The values of a variable for all objects
+    const float* column(std::size_t index) const
+    { return m_columns[index].data(); }
+
+    /// Value returned by index() for unknown variables
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  private:
+    /// Names of the variables
+    std::vector<std::string> m_names;
+    /// Accessors of the variables
+    std::vector<SG::AuxElement::ConstAccessor<float> > m_accessors;
+    /// The variables, one column each
+    std::vector<std::vector<float> > m_columns;
+    /// Number of objects
+    std::size_t m_size;
+
+  }; // class ObjectBatch
+
+  /// A calibration of a whole batch of objects at once
+  ///
+  /// Instead of one virtual call per object, there is one per batch.
+  /// Implementations should compute the results in plain loops over the
+  /// columns, with no calls and no branches the compiler can't turn into
+  /// selects, so that the loop is vectorised for the instruction set the
+  /// package is built for (e.g. with -mavx2).
+  ///
+  class BatchKernel {
+
+  public:
+    /// Virtual destructor
+    virtual ~BatchKernel() {}
+
+    /// Prepare for a batch with this layout, e.g. find the columns
+    virtual StatusCode initialize(const ObjectBatch& batch) = 0;
+
+    /// Compute one result per object of the batch
+    ///
+    /// @param batch The input objects, with the layout given to
+    ///              initialize()
+    /// @param result Array of batch.size() values to fill
+    virtual void apply(const ObjectBatch& batch, float* result) const = 0;
+
+  }; // class BatchKernel
+
+  /// A pt calibration with a response correction in bins of |eta|
+  ///
+  /// result = pt * scale[bin(|eta|)], with uniform bins between 0 and
+  /// etaMax. Objects beyond etaMax use the last bin.
+  ///
+  class EtaBinnedScale : public BatchKernel {
+
+  public:
+    /// Constructor with the binning and the scale of every bin
+    EtaBinnedScale(float etaMax, const std::vector<float>& scales,
+                   const std::string& ptName = "pt",
+                   const std::string& etaName = "eta");
+
+    /// Find the pt and eta columns
+    virtual StatusCode initialize(const ObjectBatch& batch);
+    /// Compute the calibrated pt of every object
+    virtual void apply(const ObjectBatch& batch, float* result) const;
+
+  private:
+    /// The scales per bin
+    std::vector<float> m_scales;
+    /// Inverse of the bin width
+    float m_invBinWidth;
+    /// Names of the input variables
+    std::string m_ptName, m_etaName;
+    /// Columns of the input variables
+    std::size_t m_ptColumn, m_etaColumn;
+
+  }; // class EtaBinnedScale
+
+  /// Write per-object results back to a gathered container as decorations
+  ///
+  /// @param objects The container, as it was given to ObjectBatch::gather()
+  /// @param offset The offset gather() returned for it
+  /// @param result The results of the whole batch
+  /// @param decorator Decorator of the variable to write
+  template<class CONT>
+  void scatter(const CONT& objects, std::size_t offset, const float* result,
+               const SG::AuxElement::Decorator<float>& decorator);
+
+  template<class CONT>
+  std::size_t ObjectBatch::gather(const CONT& objects)
+  {
+    const std::size_t offset = m_size;
+    const std::size_t n = objects.size();
+    m_size += n;
+    if(n == 0) return offset;
+
+    // Containers owning their elements have all variables in contiguous
+    // aux vectors, in the order of the elements. Copy them in one go.
+    // View containers have to be read element by element.
+    const bool contiguous = (objects.ownPolicy() == SG::OWN_ELEMENTS);
+    for(std::size_t v = 0; v < m_columns.size(); ++v) {
+      std::vector<float>& column = m_columns[v];
+      column.resize(m_size);
+      float* out = column.data() + offset;
+      const SG::AuxElement::ConstAccessor<float>& acc = m_accessors[v];
+      if(contiguous) {
+        const float* in = acc.getDataArray(objects);
+        for(std::size_t i = 0; i < n; ++i) out[i] = in[i];
+      }
+      else {
+        for(std::size_t i = 0; i < n; ++i) out[i] = acc(*objects[i]);
+      }
+    }
+    return offset;
+  }
+
+  template<class CONT>
+  void scatter(const CONT& objects, std::size_t offset, const float* result,
+               const SG::AuxElement::Decorator<float>& decorator)
+  {
+    const std::size_t n = objects.size();
+    for(std::size_t i = 0; i < n; ++i) {
+      decorator(*objects[i]) = result[offset + i];
+    }
+  }
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_BATCHCALIBRATION_H
@@ -0,0 +1,171 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_BENCHMARK_H
+#define CPTUTORIALEXAMPLE_BENCHMARK_H
+
+// System includes
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  class ResultWriter;
+  class ResultReader;
+
+  /// Log-binned histogram of durations
+  ///
+  /// Uses constant memory however many samples are filled, and can be
+  /// merged across workers. Quantiles are resolved to the width of one
+  /// bin, 20 bins per decade between 1 ns and 1000 s; the mean and the
+  /// maximum are exact.
+  ///
+  class LatencyHistogram {
+
+  public:
+    /// Constructor
+    LatencyHistogram();
+
+    /// Add one duration [s]
+    void fill(double seconds);
+    /// Merge another histogram into this one
+    LatencyHistogram& operator+=(const LatencyHistogram& rhs);
+
+    /// Number of samples
+    unsigned long long count() const { return m_count; }
+    /// Sum of all samples [s]
+    double total() const { return m_sum; }
+    /// Mean duration [s]
+    double mean() const { return m_count ? m_sum / m_count : 0.; }
+    /// Longest duration [s]
+    double max() const { return m_max; }
+    /// Duration below which the given fraction of the samples lie [s]
+    double quantile(double fraction) const;
+
+    /// Write the histogram, to send it to another process
+    void write(ResultWriter& out) const;
+    /// Read a histogram written by write()
+    bool read(ResultReader& in);
+
+  private:
+    /// Bin counts
+    std::vector<unsigned long long> m_bins;
+    /// Number of samples
+    unsigned long long m_count;
+    /// Sum of the samples [s]
+    double m_sum;
+    /// Largest sample [s]
+    double m_max;
+
+  }; // class LatencyHistogram
+
+  /// Per-phase timing of the event loop
+  class PhaseTimes {
+
+  public:
+    /// The timed phases of one event
+    enum Phase {
+      GetEntry = 0, ///< TEvent::getEntry()
+      Retrieve,     ///< Retrieving the input containers
+      Preselect,    ///< The EventInfo preselection
+      Tools,        ///< Calling the CP tools
+      Clear,        ///< Clearing the transient store
+      Block,        ///< Block-level stages, in block mode
+      Event,        ///< The whole event
+      NPhases
+    };
+
+    /// Name of a phase, as used in the reports
+    static const char* phaseName(Phase phase);
+
+    /// Record the duration of one phase of one event (or block) [s]
+    void fill(Phase phase, double seconds) { m_phases[phase].fill(seconds); }
+    /// Timing of one phase
+    const LatencyHistogram& phase(Phase phase) const
+    { return m_phases[phase]; }
+    /// Merge another set of timings into this one
+    PhaseTimes& operator+=(const PhaseTimes& rhs);
+
+    /// Print a table of the phase timings
+    void print(const char* location) const;
+    /// Append the phase timings to a JSON document, as an object
+    void writeJson(std::string& json, const std::string& indent) const;
+
+    /// Write the timings, to send them to another process
+    void write(ResultWriter& out) const;
+    /// Read timings written by write()
+    bool read(ResultReader& in);
+
+  private:
+    /// One histogram per phase
+    LatencyHistogram m_phases[NPhases];
+
+  }; // class PhaseTimes
+
+  /// Stopwatch measuring successive phases
+  ///
+  /// lap() returns the time since the previous lap (or construction) and
+  /// restarts the measurement, so consecutive phases are timed with one
+  /// clock reading each.
+  ///
+  class PhaseClock {
+
+  public:
+    typedef std::chrono::steady_clock clock;
+
+    PhaseClock() : m_last(clock::now()) {}
+
+    /// Time since the last lap [s]
+    double lap()
+    {
+      const clock::time_point now = clock::now();
+      const double result = std::chrono::duration<double>(now - m_last).count();
+      m_last = now;
+      return result;
+    }
+
+  private:
+    clock::time_point m_last;
+
+  }; // class PhaseClock
+
+  /// Times the phases of an event, or of a block of events
+  ///
+  /// Does nothing unless enabled, so that it can stay in the event loop
+  /// outside of benchmark mode. Time spent outside of the named phases
+  /// only counts towards the whole event.
+  ///
+  class PhaseTimer {
+
+  public:
+    PhaseTimer(bool enabled, PhaseTimes& times)
+      : m_enabled(enabled), m_times(times), m_clock(), m_total(0) {}
+
+    /// End a phase, recording it unless it is PhaseTimes::Event
+    void endPhase(PhaseTimes::Phase phase)
+    {
+      if(!m_enabled) return;
+      const double t = m_clock.lap();
+      m_total += t;
+      if(phase != PhaseTimes::Event) m_times.fill(phase, t);
+    }
+    /// Record the whole time as that of n events, sharing it evenly
+    void endEvents(unsigned int n)
+    {
+      if(!m_enabled || n == 0) return;
+      for(unsigned int i = 0; i < n; ++i) {
+        m_times.fill(PhaseTimes::Event, m_total / n);
+      }
+    }
+
+  private:
+    bool m_enabled;
+    PhaseTimes& m_times;
+    PhaseClock m_clock;
+    double m_total;
+
+  }; // class PhaseTimer
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_BENCHMARK_H
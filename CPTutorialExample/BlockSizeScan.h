@@ -0,0 +1,45 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_BLOCKSIZESCAN_H
+#define CPTUTORIALEXAMPLE_BLOCKSIZESCAN_H
+
+// System includes
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct JobConfig;
+
+  /// Outcome of running the job with one block size
+  struct BlockSizeResult {
+    BlockSizeResult();
+
+    /// The block size used
+    unsigned int blockSize;
+    /// Number of events processed
+    Long64_t nEvents;
+    /// Wall-clock time of the event loop [s]
+    double wallTime;
+    /// Mean time of one event [s]
+    double meanEventTime;
+  }; // struct BlockSizeResult
+
+  /// Run the job once per block size in config.blockSizeScan
+  ///
+  /// Prints the event rate of every block size and which one was the
+  /// fastest. As in compareAccessModes(), the runs follow each other in
+  /// the same process, so the first one also warms up the page cache;
+  /// listing the smallest size twice gives a fair first measurement.
+  ///
+  StatusCode scanBlockSizes(const JobConfig& config,
+                            std::vector<BlockSizeResult>* results = 0);
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_BLOCKSIZESCAN_H
@@ -0,0 +1,62 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_CHECK_H
+#define CPTUTORIALEXAMPLE_CHECK_H
+
+// ROOT includes
+#include "TError.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+/// @name Branch prediction hints for the checks of the event loop
+/// @{
+#if defined(__GNUC__) || defined(__clang__)
+#   define CPT_LIKELY( X ) __builtin_expect(!!(X), 1)
+#   define CPT_UNLIKELY( X ) __builtin_expect(!!(X), 0)
+#   define CPT_COLD __attribute__((cold, noinline))
+#else
+#   define CPT_LIKELY( X ) (X)
+#   define CPT_UNLIKELY( X ) (X)
+#   define CPT_COLD
+#endif
+/// @}
+
+namespace CPTutorial {
+
+  /// Print the message of a failed check
+  ///
+  /// Out of line and marked cold, so that the checks only leave a test
+  /// and a call in the code around them, and all the formatting lives
+  /// away from the hot path.
+  CPT_COLD void reportCheckFailure(const char* context,
+                                   const char* expression,
+                                   const char* file, int line);
+
+  /// @name Uniform success tests for the different return types we check
+  /// @{
+  inline bool isSuccess(bool result) { return result; }
+  template<typename T>
+  inline bool isSuccess(T* ptr) { return ptr != 0; }
+  template<typename T>
+  inline bool isSuccess(const T& code) { return code.isSuccess(); }
+  /// @}
+
+} // namespace CPTutorial
+
+/// Error checking macro for functions returning a StatusCode
+///
+/// The library counterpart of the @c CHECK macro of the executable:
+/// prints the failed expression with the given context and returns
+/// StatusCode::FAILURE from the enclosing function. Success is the
+/// predicted branch; the expression text is a string literal that is
+/// only looked at by reportCheckFailure().
+#define CPT_RETURN_CHECK( CONTEXT, ARG )                                \
+  do {                                                                  \
+    if(CPT_UNLIKELY(!::CPTutorial::isSuccess(ARG))) {                   \
+      ::CPTutorial::reportCheckFailure(CONTEXT, #ARG, __FILE__,         \
+                                       __LINE__);                       \
+      return StatusCode::FAILURE;                                       \
+    }                                                                   \
+  } while( false )
+
+#endif // CPTUTORIALEXAMPLE_CHECK_H
@@ -0,0 +1,183 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_COLUMNAROUTPUT_H
+#define CPTUTORIALEXAMPLE_COLUMNAROUTPUT_H
+
+// System includes
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Forward declaration(s)
+class TFile;
+class TTree;
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct OutputConfig;
+
+  /// Types a column can have
+  enum ColumnType {
+    kFloatColumn = 0,   ///< Float_t per event
+    kDoubleColumn,      ///< Double_t per event
+    kIntColumn,         ///< Int_t per event
+    kUIntColumn,        ///< UInt_t per event
+    kULong64Column,     ///< ULong64_t per event
+    kFloatArrayColumn   ///< Variable number of Float_t per event
+  };
+
+  /// Column type of a C++ type
+  template<typename T> struct ColumnTypeOf;
+  template<> struct ColumnTypeOf<Float_t>
+  { static const ColumnType value = kFloatColumn; };
+  template<> struct ColumnTypeOf<Double_t>
+  { static const ColumnType value = kDoubleColumn; };
+  template<> struct ColumnTypeOf<Int_t>
+  { static const ColumnType value = kIntColumn; };
+  template<> struct ColumnTypeOf<UInt_t>
+  { static const ColumnType value = kUIntColumn; };
+  template<> struct ColumnTypeOf<ULong64_t>
+  { static const ColumnType value = kULong64Column; };
+
+  /// The columns of the output, in order
+  class ColumnSchema {
+
+  public:
+    /// Declare a column, returning its index
+    std::size_t add(const std::string& name, ColumnType type);
+    /// Index of a column by name, or npos if it was not declared
+    std::size_t index(const std::string& name) const;
+
+    /// Number of columns
+    std::size_t size() const { return m_names.size(); }
+    /// Name of a column
+    const std::string& name(std::size_t i) const { return m_names[i]; }
+    /// Type of a column
+    ColumnType type(std::size_t i) const { return m_types[i]; }
+
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  private:
+    std::vector<std::string> m_names;
+    std::vector<ColumnType> m_types;
+
+  }; // class ColumnSchema
+
+  /// Per-worker buffer of output rows, stored column by column
+  ///
+  /// Each column keeps its values for all buffered rows in one
+  /// contiguous vector; array columns keep a flat value vector plus the
+  /// offset at which each row ends. clear() keeps the capacity, so after
+  /// the first flush no allocation happens on the event loop.
+  ///
+  class ColumnBuffer {
+
+  public:
+    /// Constructor with the columns to buffer
+    ColumnBuffer(const ColumnSchema& schema);
+
+    /// Set a scalar column of the current row
+    template<typename T>
+    void set(std::size_t column, T value)
+    {
+      if(!checkType(column, ColumnTypeOf<T>::value)) return;
+      Column& col = m_columns[column];
+      std::memcpy(&col.bytes[m_rows * col.width], &value, sizeof(T));
+    }
+    /// Append a value to an array column of the current row
+    void push(std::size_t column, Float_t value)
+    {
+      if(!checkType(column, kFloatArrayColumn)) return;
+      m_columns[column].values.push_back(value);
+    }
+    /// Finish the current row and start a new one
+    void endRow();
+
+    /// Number of finished rows
+    std::size_t rows() const { return m_rows; }
+    /// Drop all rows, keeping the memory
+    void clear();
+
+  private:
+    friend class ColumnarOutput;
+
+    /// Storage of one column
+    struct Column {
+      ColumnType type;
+      /// Bytes per value of a scalar column
+      std::size_t width;
+      /// Scalar values, one per row (plus the row being filled)
+      std::vector<unsigned char> bytes;
+      /// Array values of all rows
+      std::vector<Float_t> values;
+      /// End offsets of the rows in values
+      std::vector<UInt_t> ends;
+    };
+
+    /// Check the type of a column, complaining about mismatches
+    bool checkType(std::size_t column, ColumnType type) const;
+
+    /// The columns
+    std::vector<Column> m_columns;
+    /// Number of finished rows
+    std::size_t m_rows;
+
+  }; // class ColumnBuffer
+
+  /// Flat columnar output tree, fed by per-worker ColumnBuffers
+  ///
+  /// The output holds one branch per column. Workers fill rows into
+  /// their own ColumnBuffer and hand it over with write() every few
+  /// thousand rows. Only write() takes a lock, so the workers never
+  /// wait for each other on a per-event basis.
+  ///
+  class ColumnarOutput {
+
+  public:
+    /// Constructor with the column schema
+    ColumnarOutput(const ColumnSchema& schema);
+    /// Destructor
+    ~ColumnarOutput();
+
+    /// Open the output file and create the tree
+    StatusCode open(const std::string& fileName, const OutputConfig& output,
+                    const std::string& treeName = "columns");
+    /// Append the rows of a buffer to the tree and clear the buffer
+    StatusCode write(ColumnBuffer& buffer);
+    /// Write the tree and close the file
+    StatusCode close();
+
+    /// The columns of the output
+    const ColumnSchema& schema() const { return m_schema; }
+    /// Rows written so far
+    Long64_t rows() const { return m_rowsWritten; }
+
+  private:
+    /// The column schema
+    ColumnSchema m_schema;
+    /// The output file
+    std::unique_ptr<TFile> m_file;
+    /// The output tree, owned by the file
+    TTree* m_tree;
+    /// Branch buffers of the scalar columns
+    std::vector<ULong64_t> m_scalars;
+    /// Branch buffers of the array columns
+    std::vector<std::vector<Float_t>*> m_arrays;
+    /// Serialises write() calls
+    std::mutex m_mutex;
+    /// Rows written so far
+    Long64_t m_rowsWritten;
+
+  }; // class ColumnarOutput
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_COLUMNAROUTPUT_H
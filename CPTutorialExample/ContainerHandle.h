@@ -0,0 +1,110 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_CONTAINERHANDLE_H
+#define CPTUTORIALEXAMPLE_CONTAINERHANDLE_H
+
+// System includes
+#include <string>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "xAODRootAccess/TEvent.h"
+
+// Local includes
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  /// A worker's xAOD::TEvent, with a count of the entries loaded into it
+  ///
+  /// The worker calls nextEntry() after every TEvent::getEntry(). Handles
+  /// compare the count with the one they last retrieved their object
+  /// at, to know whether it is still the current one.
+  ///
+  class EventCursor {
+
+  public:
+    /// Constructor
+    EventCursor() : m_event(0), m_generation(1) {}
+
+    /// Set the event the handles retrieve their objects from
+    void setEvent(xAOD::TEvent* event) { m_event = event; ++m_generation; }
+    /// Tell the handles that a new entry was loaded
+    void nextEntry() { ++m_generation; }
+
+    /// The event
+    xAOD::TEvent* event() const { return m_event; }
+    /// Number of the entry loaded last; never 0
+    ULong64_t generation() const { return m_generation; }
+
+  private:
+    xAOD::TEvent* m_event;
+    ULong64_t m_generation;
+
+  }; // class EventCursor
+
+  /// An input object of a given type and key, looked up once per entry
+  ///
+  /// xAOD::TEvent::retrieve() with a string key hashes the key and
+  /// searches for it on every call. The handle hashes the key once, on
+  /// first use, and then retrieves by hash, once per entry; further
+  /// get() calls for the same entry only load the cached pointer. Each
+  /// worker needs its own handles, e.g.
+  ///
+  ///   ContainerHandle<xAOD::JetContainer> m_jets("AntiKt4EMTopoJets");
+  ///   ...
+  ///   const xAOD::JetContainer* jets = m_jets.get(context.cursor);
+  ///   if(!jets) return false;
+  ///
+  template<typename T>
+  class ContainerHandle {
+
+  public:
+    /// Constructor with the key of the object
+    explicit ContainerHandle(const std::string& key)
+      : m_key(key), m_hash(0), m_hashed(false), m_object(0), m_generation(0)
+    {}
+
+    /// The object for the current entry, or null if it doesn't exist
+    const T* get(const EventCursor& cursor)
+    {
+      if(CPT_LIKELY(m_generation == cursor.generation())) return m_object;
+      return retrieve(cursor);
+    }
+
+    /// Key of the object
+    const std::string& key() const { return m_key; }
+
+  private:
+    /// Look the object up for a new entry
+    const T* retrieve(const EventCursor& cursor)
+    {
+      xAOD::TEvent* event = cursor.event();
+      m_object = 0;
+      if(!event) return 0;
+      if(CPT_UNLIKELY(!m_hashed)) {
+        m_hash = event->getHash(m_key);
+        m_hashed = true;
+      }
+      if(!event->retrieve(m_object, m_hash)) m_object = 0;
+      m_generation = cursor.generation();
+      return m_object;
+    }
+
+    /// Key of the object
+    std::string m_key;
+    /// Hash of the key, as used by TEvent
+    unsigned int m_hash;
+    /// Whether m_hash was computed
+    bool m_hashed;
+    /// The object of the entry m_generation
+    const T* m_object;
+    /// Cursor generation m_object was retrieved at, 0 for never
+    ULong64_t m_generation;
+
+  }; // class ContainerHandle
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_CONTAINERHANDLE_H
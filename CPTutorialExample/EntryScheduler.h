@@ -0,0 +1,89 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_ENTRYSCHEDULER_H
+#define CPTUTORIALEXAMPLE_ENTRYSCHEDULER_H
+
+// System includes
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Forward declaration(s)
+class TTree;
+
+namespace CPTutorial {
+
+  /// A half-open range of entries, [begin, end)
+  struct EntryRange {
+    EntryRange() : begin(0), end(0) {}
+    EntryRange(Long64_t b, Long64_t e) : begin(b), end(e) {}
+    Long64_t size() const { return end - begin; }
+
+    Long64_t begin;
+    Long64_t end;
+  }; // struct EntryRange
+
+  /// Entry ranges processed together by one worker
+  typedef std::vector<EntryRange> EntryGroup;
+
+  /// Group sorted ranges of selected entries by the clusters of a tree
+  ///
+  /// The ranges are cut at the cluster boundaries, and all pieces inside
+  /// the same cluster go into one group, so that a cluster with many
+  /// small selected ranges is still decompressed by one worker only.
+  /// Without a tree, or if it has no cluster information, aligned
+  /// windows of fallbackSize entries stand in for the clusters.
+  std::vector<EntryGroup> clusterGroups(TTree* tree,
+                                        const std::vector<EntryRange>& ranges,
+                                        Long64_t fallbackSize = 100);
+
+  /// Work-stealing scheduler handing out groups of entries to workers
+  ///
+  /// The groups are initially dealt out in contiguous blocks, one block
+  /// per worker, to preserve read locality. Each worker takes groups from
+  /// the front of its own queue; once that is empty it steals from the
+  /// back of the queue of the worker with the most remaining entries.
+  /// All member functions are thread-safe.
+  ///
+  class EntryScheduler {
+
+  public:
+    /// Constructor with the groups to process and the number of workers
+    EntryScheduler(const std::vector<EntryGroup>& groups,
+                   unsigned int nWorkers);
+
+    /// Get the next group for a worker
+    ///
+    /// @param worker Index of the calling worker
+    /// @param group  Set to the group to process
+    /// @param stolen Set to true if the group came from another worker
+    /// @returns false once there is no work left anywhere
+    bool next(unsigned int worker, EntryGroup& group, bool& stolen);
+
+    /// Number of workers
+    unsigned int nWorkers() const { return m_queues.size(); }
+
+  private:
+    /// The work queue of one worker
+    struct Queue {
+      Queue() : remaining(0) {}
+      std::mutex mutex;
+      std::deque<EntryGroup> groups;
+      /// Entries left in the queue, to choose a victim to steal from
+      Long64_t remaining;
+    };
+
+    /// Try to steal one group for the given worker
+    bool steal(unsigned int thief, EntryGroup& group);
+
+    /// One queue per worker
+    std::vector<std::unique_ptr<Queue> > m_queues;
+
+  }; // class EntryScheduler
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_ENTRYSCHEDULER_H
@@ -0,0 +1,83 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_EVENTBLOCK_H
+#define CPTUTORIALEXAMPLE_EVENTBLOCK_H
+
+// System includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Forward declaration(s)
+namespace xAOD {
+  class EventInfo_v1;
+  typedef EventInfo_v1 EventInfo;
+}
+
+namespace CPTutorial {
+
+  /// One float per object of the events of a block
+  ///
+  /// For the results of block stages, which can't decorate the objects
+  /// any more once the entry is gone. The objects of event i of the
+  /// block are [offsets[i], offsets[i+1]) of the values.
+  ///
+  struct ObjectColumn {
+    /// Name of the values, e.g. of the decoration they replace
+    std::string name;
+    /// Offset of the first object of every event, then the total
+    std::vector<std::size_t> offsets;
+    /// The values
+    std::vector<float> values;
+  }; // struct ObjectColumn
+
+  /// Per-event quantities of a block of events, one array each
+  ///
+  /// TEvent holds only one entry at a time, and the transient store is
+  /// cleared after each of them. What the block-level stages and the
+  /// output need is therefore copied here while the entry is loaded.
+  /// The arrays keep their capacity from block to block.
+  ///
+  struct EventBlock {
+    EventBlock() : nEntries(0) {}
+
+    /// Number of events in the block
+    std::size_t size() const { return entry.size(); }
+    /// Number of entries read for the block, including rejected ones
+    Long64_t nEntries;
+    /// Remove all events, keeping the allocated memory
+    void clear();
+    /// Add the event currently loaded
+    void push(Long64_t entryIndex, const xAOD::EventInfo& info);
+
+    /// Entry numbers in the input tree
+    std::vector<Long64_t> entry;
+    /// EventInfo variables
+    std::vector<UInt_t> runNumber;
+    std::vector<ULong64_t> eventNumber;
+    std::vector<UInt_t> lumiBlock;
+    std::vector<Float_t> averageMu;
+    /// MC event weight, 1 for data
+    std::vector<Float_t> mcEventWeight;
+
+    /// Per-object results of the block stages
+    std::vector<ObjectColumn> objects;
+    /// The object column of a name, added if it doesn't exist yet
+    ObjectColumn& objectColumn(const std::string& name);
+
+
+
+
+    // @@@ Add the batches of your block stages here, e.g. @@@ //
+    //   ObjectBatch jets;
+    // and clear them in clear().
+
+
+
+
+  }; // struct EventBlock
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_EVENTBLOCK_H
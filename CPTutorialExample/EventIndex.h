@@ -0,0 +1,80 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_EVENTINDEX_H
+#define CPTUTORIALEXAMPLE_EVENTINDEX_H
+
+// System includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/EntryScheduler.h"
+
+namespace CPTutorial {
+
+  /// 64-bit FNV-1a hash of a string
+  ULong64_t fnv1aHash(const std::string& text);
+
+  /// Entries of one input file passing the preselection, kept on disk
+  ///
+  /// A run with the same preselection over the same file can then read
+  /// only the selected entries, instead of scanning EventInfo of the
+  /// whole file again. Index files are named after the UUID of the
+  /// input file and the hash of the selection, so that a changed
+  /// selection or a different file never matches.
+  ///
+  /// The file holds a header (magic, selection hash, number of tree
+  /// entries and of selected entries), the selected entry numbers as
+  /// varint-encoded differences to the previous one, and a checksum of
+  /// everything before it. A typical index is a few bits per selected
+  /// event.
+  ///
+  class EventIndex {
+
+  public:
+    /// Constructor
+    EventIndex();
+
+    /// Name of the index file of an input file for a selection
+    static std::string fileName(const std::string& directory,
+                                const std::string& fileUUID,
+                                ULong64_t selectionHash);
+
+    /// Read an index file
+    ///
+    /// Returns false, without an error, if the file doesn't exist. A
+    /// file that is corrupt or doesn't match the selection hash and the
+    /// number of tree entries is also refused, with a warning.
+    bool read(const std::string& fileName, ULong64_t selectionHash,
+              Long64_t treeEntries);
+    /// Write an index file, replacing an existing one atomically
+    StatusCode write(const std::string& fileName,
+                     ULong64_t selectionHash) const;
+
+    /// Set the contents, the selected entries don't need to be sorted
+    void set(Long64_t treeEntries, const std::vector<Long64_t>& entries);
+    /// Number of entries of the indexed tree
+    Long64_t treeEntries() const { return m_treeEntries; }
+    /// The selected entries, sorted
+    const std::vector<Long64_t>& entries() const { return m_entries; }
+
+    /// The selected entries within a range, as ranges of consecutive
+    /// entries
+    std::vector<EntryRange> ranges(const EntryRange& range) const;
+
+  private:
+    /// Number of entries of the indexed tree
+    Long64_t m_treeEntries;
+    /// The selected entries, sorted
+    std::vector<Long64_t> m_entries;
+
+  }; // class EventIndex
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_EVENTINDEX_H
@@ -0,0 +1,147 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_EVENTLOOP_H
+#define CPTUTORIALEXAMPLE_EVENTLOOP_H
+
+// System includes
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/EventWorker.h"
+#include "CPTutorialExample/EntryScheduler.h"
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct JobConfig;
+  class AsyncLogSink;
+  class ProgressReporter;
+  class ColumnarOutput;
+  class HistogramBook;
+  class SkimWriter;
+  class MemoryMonitor;
+  class StartupTimer;
+
+  /// Drives the event loop of the job
+  ///
+  /// The input files are processed one after the other, with the next
+  /// file opened in the background by a FilePrefetcher. With a single
+  /// thread each file is processed by the plain loop of the tutorial
+  /// skeleton. With JobConfig::nThreads > 1 the entry range is cut at
+  /// the cluster boundaries of the input tree and handed out to one
+  /// EventWorker per thread through a work-stealing EntryScheduler. With
+  /// JobConfig::pipelineThreads > 0 the loop stays on the main thread,
+  /// but the baskets of the input are decompressed ahead of it on ROOT's
+  /// thread pool. The worker results are merged at the end. With
+  /// JobConfig::nProcesses > 1 the job forks after the setup of the
+  /// first worker, so that the processes share its CP tools and their
+  /// calibration data copy-on-write. Each process takes a slice of the
+  /// entries, and their outputs are merged when they are done.
+  ///
+  class EventLoop {
+
+  public:
+    /// Constructor
+    EventLoop(const JobConfig& config);
+    /// Destructor
+    ~EventLoop();
+
+    /// Run the whole event loop
+    StatusCode run();
+    /// Set the timer of the start-up steps, null for none
+    void setStartupTimer(StartupTimer* startup) { m_startup = startup; }
+
+    /// Merged results of all workers
+    const WorkerResult& result() const { return m_result; }
+    /// Wall-clock time of the whole loop [s]
+    double wallTime() const { return m_wallTime; }
+    /// Results of the individual workers
+    const std::vector<WorkerResult>& workerResults() const
+    { return m_workerResults; }
+
+  private:
+    /// Clock of the wall-time measurements
+    typedef std::chrono::steady_clock Clock;
+
+    /// The event loop, in the parent or in one forked process
+    StatusCode runLoop();
+    /// Fork the processes, giving each a slice of [first, last)
+    StatusCode forkProcesses(Long64_t& first, Long64_t& last);
+    /// Wait for the forked processes and merge their outputs
+    StatusCode mergeProcesses(const Clock::time_point& start);
+    /// Kill and wait for the processes forked so far, and remove their parts
+    void abortProcesses();
+    /// Remove the parts of the outputs written by the forked processes
+    void removeParts(unsigned int nParts) const;
+    /// Report the result of a forked process to the parent and exit
+    void finishProcess(const StatusCode& result);
+    /// Name of an output file of this process
+    std::string outputName(const std::string& fileName) const;
+
+    /// Process ranges of the current file with nThreads workers
+    StatusCode runThreaded(const std::string& fileName,
+                           const std::vector<EntryRange>& ranges);
+    /// Print the summary and write the reports the job asked for
+    StatusCode report() const;
+    /// Print the per-worker and total throughput
+    void printSummary() const;
+    /// Write the benchmark report as JSON
+    StatusCode writeBenchmark(const std::string& fileName) const;
+
+    /// The job configuration
+    const JobConfig& m_config;
+    /// The workers, the first one runs on the main thread
+    std::vector<std::unique_ptr<EventWorker> > m_workers;
+    /// Time each worker spent waiting for the others at the end of a file
+    std::vector<double> m_tailTime;
+    /// Merged results
+    WorkerResult m_result;
+    /// Per-worker results
+    std::vector<WorkerResult> m_workerResults;
+    /// Wall-clock time of the whole loop [s]
+    double m_wallTime;
+    /// Time spent waiting for input files to open [s]
+    double m_fileWaitTime;
+
+    /// Sink of the progress messages during the loop
+    std::unique_ptr<AsyncLogSink> m_logSink;
+    /// Progress reporter shared by the workers
+    std::unique_ptr<ProgressReporter> m_progress;
+    /// Timer of the start-up steps, if any
+    StartupTimer* m_startup;
+    /// Memory figures of the progress messages, if requested
+    std::unique_ptr<MemoryMonitor> m_memoryMonitor;
+    /// Columnar output shared by the workers, if requested
+    std::unique_ptr<ColumnarOutput> m_columnarOutput;
+    /// Histograms filled by the workers, if requested
+    std::unique_ptr<HistogramBook> m_histogramBook;
+    /// Copy of the selected events, if requested
+    std::unique_ptr<SkimWriter> m_skimWriter;
+
+    /// A forked process, seen from the parent
+    struct ChildProcess {
+      /// Process ID
+      int pid;
+      /// Read end of the pipe the process reports its result through
+      int resultPipe;
+    };
+    /// Index of this process in --processes mode, -1 in the parent
+    int m_process;
+    /// Write end of the result pipe, in a forked process
+    int m_resultPipe;
+    /// The forked processes, in the parent, in the order of their slices
+    std::vector<ChildProcess> m_children;
+
+  }; // class EventLoop
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_EVENTLOOP_H
@@ -0,0 +1,74 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_EVENTPRESELECTION_H
+#define CPTUTORIALEXAMPLE_EVENTPRESELECTION_H
+
+// System includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/GoodRunsList.h"
+
+// Forward declaration(s)
+namespace xAOD {
+  class EventInfo_v1;
+  typedef EventInfo_v1 EventInfo;
+}
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct JobConfig;
+
+  /// Cheap event selection using only EventInfo
+  ///
+  /// Cuts on the run number and, for data, on the lumiblocks of
+  /// good-run lists. Applied right after EventInfo is retrieved, before
+  /// the CP tools run. TEvent deserialises containers only when they
+  /// are retrieved, so the heavy containers of a rejected event are
+  /// never deserialised. They may still be read and decompressed: the
+  /// TTreeCache prefetches the branches it learned for whole clusters,
+  /// and a basket shared with an accepted entry is decompressed anyway.
+  ///
+  class EventPreselection {
+
+  public:
+    /// Constructor with the cuts of the job configuration
+    EventPreselection(const JobConfig& config);
+
+    /// Read the good-run lists
+    StatusCode initialize();
+
+    /// Whether any cut is applied
+    bool active() const { return m_active; }
+    /// Whether an event passes the preselection
+    bool accept(const xAOD::EventInfo& info) const;
+    /// Canonical description of the cuts, for hashing
+    ///
+    /// Two preselections with the same description select the same
+    /// events from the same input.
+    std::string description() const;
+
+  private:
+    /// Whether any cut is applied
+    bool m_active;
+    /// Accepted runs, sorted, empty for all
+    std::vector<UInt_t> m_runs;
+    /// Accepted run range [first, last]
+    UInt_t m_firstRun, m_lastRun;
+    /// Good-run list files
+    std::vector<std::string> m_grlFiles;
+    /// Good lumiblocks of the data, if any GRL files are given
+    GoodRunsList m_grl;
+
+  }; // class EventPreselection
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_EVENTPRESELECTION_H
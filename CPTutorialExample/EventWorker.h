@@ -0,0 +1,296 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_EVENTWORKER_H
+#define CPTUTORIALEXAMPLE_EVENTWORKER_H
+
+// System includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/ReadCache.h"
+#include "CPTutorialExample/Benchmark.h"
+#include "CPTutorialExample/RecyclingStore.h"
+#include "CPTutorialExample/ColumnarOutput.h"
+#include "CPTutorialExample/Histograms.h"
+#include "CPTutorialExample/MemoryAccounting.h"
+#include "CPTutorialExample/EventBlock.h"
+#include "CPTutorialExample/EventPreselection.h"
+#include "CPTutorialExample/SystematicsDriver.h"
+#include "CPTutorialExample/ToolStage.h"
+#include "CPTutorialExample/StaticPipeline.h"
+#include "CPTutorialExample/ContainerHandle.h"
+
+// Forward declarations
+class TFile;
+class TTree;
+namespace xAOD {
+  class TEvent;
+  class TStore;
+}
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct JobConfig;
+  class EntryScheduler;
+  class ProgressReporter;
+  class StartupTimer;
+  class ResultWriter;
+  class ResultReader;
+
+  /// Statistics collected by one worker, summed up at the end of the job
+  struct WorkerResult {
+    WorkerResult();
+    /// Merge the results of another worker into this one
+    WorkerResult& operator+=(const WorkerResult& rhs);
+
+    /// Write the results, to send them to another process
+    void write(ResultWriter& out) const;
+    /// Read results written by write()
+    bool read(ResultReader& in);
+
+    /// Number of events processed, including preselection rejects
+    Long64_t nProcessed;
+    /// Number of events rejected by the preselection
+    Long64_t nRejected;
+    /// Wall-clock time spent in the event loop [s]
+    double loopTime;
+    /// Time spent waiting for work, including the end-of-job tail [s]
+    double idleTime;
+    /// Number of entry ranges, or scheduler groups, processed
+    Long64_t nRanges;
+    /// Number of scheduler groups stolen from other workers
+    Long64_t nStolen;
+    /// I/O statistics of the files this worker read
+    ReadStats readStats;
+    /// Time spent setting up the CP tools [s]
+    double toolSetupTime;
+    /// Per-phase event timing, filled in benchmark mode only
+    PhaseTimes phaseTimes;
+    /// Statistics of the RecyclingStore, if used
+    RecyclingStats recycling;
+    /// Number of systematic variations run, summed over the events
+    Long64_t nVariations;
+    /// Number of variations skipped because they affect no tool
+    Long64_t nSkippedVariations;
+    /// Heap allocations made in the event loop, with --memory-report
+    AllocationCount allocations;
+    /// Per-container memory use, with --memory-report
+    MemoryAccount memory;
+  }; // struct WorkerResult
+
+  /// One independent event-processing unit
+  ///
+  /// Every worker owns its own input file handle, xAOD::TEvent and
+  /// xAOD::TStore, so that several of them can process disjoint entry
+  /// ranges of the same file on different threads. The event, the store
+  /// and the CP tools live for the whole job, while the input file can be
+  /// switched between ranges. A worker must only ever be used from one
+  /// thread at a time.
+  ///
+  class EventWorker {
+
+  public:
+    /// Constructor with the worker's index in the job
+    EventWorker(unsigned int index, const JobConfig& config);
+    /// Destructor
+    ~EventWorker();
+
+    /// Set up the event, the store and the CP tools
+    ///
+    /// With JobConfig::lazyInit the CP tools are only set up when the
+    /// first event passes the preselection.
+    StatusCode initialize();
+    /// Open an input file and start reading from it
+    StatusCode openFile(const std::string& fileName);
+    /// Start reading from an already opened input file
+    StatusCode setInput(std::unique_ptr<TFile> file);
+    /// Close the current input file, collecting its I/O statistics
+    void closeFile();
+    /// Flush the outputs, close the input and collect the statistics
+    StatusCode finalize();
+    /// Process the entries [begin, end)
+    StatusCode processRange(Long64_t begin, Long64_t end);
+    /// Process groups handed out by the scheduler until none are left
+    StatusCode process(EntryScheduler& scheduler);
+    /// Process a single entry
+    StatusCode execute(Long64_t entry);
+    /// Process the entries [begin, end) as one block
+    ///
+    /// Every entry is loaded in turn and goes through the per-event
+    /// stages. The block-level stages and the output then run once over
+    /// everything gathered from the block.
+    StatusCode executeBlock(Long64_t begin, Long64_t end);
+
+    /// Number of entries in the input file
+    Long64_t entries() const;
+    /// The event tree of the input file
+    TTree* inputTree() const;
+    /// Set the progress reporter counting the processed events
+    void setProgress(ProgressReporter* progress) { m_progress = progress; }
+    /// Set the timer marking the end of the first block, null for none
+    void setStartupTimer(StartupTimer* startup) { m_startup = startup; }
+    /// Set the monitor the allocations of every block are added to
+    void setMemoryMonitor(MemoryMonitor* memory) { m_memoryMonitor = memory; }
+    /// Set the columnar output this worker writes rows to
+    void setColumnarOutput(ColumnarOutput* output);
+    /// Declare the columns the workers fill in the columnar output
+    static void declareColumns(ColumnSchema& schema);
+    /// Set the histograms this worker fills, null for none
+    void setHistograms(const HistogramBook* book);
+    /// Book the histograms the workers fill
+    static void declareHistograms(HistogramBook& book);
+    /// This worker's histogram contents, if it fills any
+    const HistogramAccumulator* histograms() const
+    { return m_histograms.get(); }
+
+    /// Move the entries that passed the preselection so far to a vector
+    ///
+    /// They are only recorded when the job caches event indices.
+    void takeAcceptedEntries(std::vector<Long64_t>& entries);
+
+    /// Whether initialize() was called successfully
+    bool isInitialized() const { return m_event.get() != 0; }
+    /// The systematics driver switching the CP tools of this worker
+    SystematicsDriver& systematics() { return m_systematics; }
+
+    /// Index of this worker
+    unsigned int index() const { return m_index; }
+    /// Statistics collected so far
+    const WorkerResult& result() const { return m_result; }
+
+    /// The recycling transient store, if it was requested
+    ///
+    /// Objects acquired from it live until the end of the current event.
+    RecyclingStore* recyclingStore() { return m_recycling.get(); }
+
+  private:
+    /// Make this worker's event and store the active ones
+    void setActive();
+    /// Create and configure the CP tools
+    StatusCode initializeTools();
+    /// Process the entries [begin, end) in blocks of the configured size
+    StatusCode executeEntries(Long64_t begin, Long64_t end);
+    /// The per-event stages of a block
+    StatusCode loadBlock(Long64_t begin, Long64_t end, EventBlock& block,
+                         PhaseTimer& timer);
+    /// The block stages and the output of a block
+    StatusCode finishBlock(EventBlock& block, PhaseTimer& timer);
+    /// Add the allocations made for nEvents events to the statistics
+    void countAllocations(const AllocationCount& count, Long64_t nEvents);
+    /// Run the stages working on a whole block of events
+    StatusCode executeBlockStages(EventBlock& block);
+    /// Fill the columnar output rows of a block
+    StatusCode fillColumns(const EventBlock& block);
+    /// Fill the histograms from a block
+    void fillHistograms(const EventBlock& block);
+    /// Run the CP tools for one systematic set of the current event,
+    /// with the block it goes into, null when not running in blocks
+    StatusCode executeSystematic(const xAOD::EventInfo& evtInfo,
+                                 std::size_t sys, EventBlock* block);
+
+    /// Index of the worker in the job
+    unsigned int m_index;
+    /// Name used in log messages
+    std::string m_name;
+    /// The job configuration
+    const JobConfig& m_config;
+
+    /// The current input file
+    std::unique_ptr<TFile> m_file;
+    /// The event object reading the input file
+    std::unique_ptr<xAOD::TEvent> m_event;
+    /// The transient store of this worker
+    std::unique_ptr<xAOD::TStore> m_store;
+    /// The recycling store of this worker, if requested
+    std::unique_ptr<RecyclingStore> m_recycling;
+    /// The event of the container handles
+    EventCursor m_cursor;
+    /// Handle of the EventInfo object
+    ContainerHandle<xAOD::EventInfo> m_eventInfo;
+
+    /// The EventInfo-only cuts applied before the CP tools
+    EventPreselection m_preselection;
+    /// Whether to record the entries passing the preselection, for the
+    /// event index or the skim
+    bool m_recordAccepted;
+    /// Entries that passed the preselection
+    std::vector<Long64_t> m_acceptedEntries;
+    /// Runs the systematic variations of every event
+    SystematicsDriver m_systematics;
+    /// One configured tool stage
+    struct Stage {
+      std::unique_ptr<ToolStage> stage;
+      /// Name of the stage, for messages
+      std::string name;
+      /// Index of the container it calibrates or reads in the
+      /// SystematicsDriver, or npos
+      std::size_t container;
+      /// Whether its results depend on the systematic set
+      bool systematic;
+    };
+    /// The tool stages of the configuration, in order
+    std::vector<Stage> m_stages;
+
+    /// The per-event stages compiled into the worker, run before the
+    /// configured ones for every systematic set
+    ///
+    /// Each stage takes a ToolContext, see StaticPipeline.
+
+
+
+    // @@@ List your compiled-in stages here, e.g. @@@ //
+    //   typedef StaticPipeline<JetCalibStage, JetSelectionStage> StaticChain;
+    typedef StaticPipeline<> StaticChain;
+
+
+
+    StaticChain m_staticChain;
+    /// Whether the CP tools were set up
+    bool m_toolsReady;
+
+    /// Progress reporter of the job, if any
+    ProgressReporter* m_progress;
+    /// Start-up timer of the job, until the first block is done
+    StartupTimer* m_startup;
+    /// Memory monitor of the job, if any
+    MemoryMonitor* m_memoryMonitor;
+    /// Entries read from the current input file
+    Long64_t m_fileEntries;
+    /// Account of the allocations made by all CP tools together
+    std::size_t m_toolsMemory;
+
+    /// Per-event quantities of the current block
+    EventBlock m_block;
+
+    /// The columnar output of the job, if any
+    ColumnarOutput* m_columnarOutput;
+    /// Rows of the columnar output not written yet
+    std::unique_ptr<ColumnBuffer> m_columnBuffer;
+    /// Indices of the EventInfo columns
+    struct EventInfoColumns {
+      std::size_t runNumber, eventNumber, lumiBlock, averageMu, mcEventWeight;
+    } m_eventInfoColumns;
+
+    /// This worker's contents of the job's histograms, if any
+    std::unique_ptr<HistogramAccumulator> m_histograms;
+    /// Indices of the EventInfo histograms
+    struct EventInfoHistograms {
+      std::size_t averageMu;
+    } m_eventInfoHistograms;
+
+    /// Statistics of this worker
+    WorkerResult m_result;
+
+  }; // class EventWorker
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_EVENTWORKER_H
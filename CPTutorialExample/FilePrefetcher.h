@@ -0,0 +1,60 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_FILEPREFETCHER_H
+#define CPTUTORIALEXAMPLE_FILEPREFETCHER_H
+
+// System includes
+#include <future>
+#include <memory>
+#include <string>
+
+// Forward declaration(s)
+class TFile;
+
+namespace CPTutorial {
+
+  /// Opens the next input file in the background
+  ///
+  /// While the current file is being processed, prefetch() opens the
+  /// next one on a separate thread and reads the objects that
+  /// xAOD::TEvent::readFrom() needs first: the event tree header and the
+  /// metadata tree. For remote files this hides most of the open latency
+  /// between two files. When asynchronous opening is disabled, take()
+  /// just opens the file synchronously.
+  ///
+  class FilePrefetcher {
+
+  public:
+    /// Constructor
+    FilePrefetcher(bool async = true);
+    /// Destructor, waits for a pending open to finish
+    ~FilePrefetcher();
+
+    /// Start opening a file
+    void prefetch(const std::string& fileName);
+    /// Get the file started with the last prefetch() call
+    ///
+    /// Blocks until the file is open. Returns a null pointer if the file
+    /// could not be opened.
+    std::unique_ptr<TFile> take();
+
+    /// Total time take() spent waiting for files [s]
+    double waitTime() const { return m_waitTime; }
+
+  private:
+    /// Open a file and read its headers
+    static TFile* openFile(const std::string& fileName);
+
+    /// Whether files are opened on a separate thread
+    bool m_async;
+    /// Name of the file being prefetched
+    std::string m_fileName;
+    /// The pending asynchronous open, if any
+    std::future<TFile*> m_pending;
+    /// Time spent waiting in take() [s]
+    double m_waitTime;
+
+  }; // class FilePrefetcher
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_FILEPREFETCHER_H
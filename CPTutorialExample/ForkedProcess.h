@@ -0,0 +1,29 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_FORKEDPROCESS_H
+#define CPTUTORIALEXAMPLE_FORKEDPROCESS_H
+
+// System includes
+#include <cstddef>
+#include <functional>
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+namespace CPTutorial {
+
+  /// Run a function in a forked process and wait for it
+  ///
+  /// The function runs in a child process forked from the caller, and
+  /// fills the @c size bytes at @c data, a trivially copyable object,
+  /// which are sent back to the caller through a pipe when it succeeds.
+  /// The child exits without running the caller's atexit handlers and
+  /// static destructors. If @c peakRss is given, it is set to the peak
+  /// resident memory of the child alone [MB], which a process running
+  /// several jobs one after the other can't measure for each of them.
+  ///
+  StatusCode runForked(const std::function<StatusCode()>& func,
+                       void* data, std::size_t size, double* peakRss = 0);
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_FORKEDPROCESS_H
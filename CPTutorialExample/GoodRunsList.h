@@ -0,0 +1,105 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_GOODRUNSLIST_H
+#define CPTUTORIALEXAMPLE_GOODRUNSLIST_H
+
+// System includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+namespace CPTutorial {
+
+  /// Good-run list compiled into per-run lumiblock bitmaps
+  ///
+  /// Ranges are collected with addRange() or readXml(), then compile()
+  /// turns them into a sorted array of runs, each with one bit per
+  /// lumiblock between its first and last good one. A lookup is a
+  /// comparison with the run of the previous lookup, which is almost
+  /// always the same one since events come ordered by run, a binary
+  /// search over the runs otherwise, and one bit test.
+  ///
+  /// The cache of the last run makes accept() unsafe to call from
+  /// several threads at once; every worker holds its own copy.
+  ///
+  class GoodRunsList {
+
+  public:
+    /// Constructor
+    GoodRunsList();
+
+    /// Largest lumiblock number kept, larger ones are ignored
+    static const UInt_t MAX_LB = 1u << 20;
+
+    /// Add the lumiblocks [firstLB, lastLB] of a run as good
+    void addRange(UInt_t run, UInt_t firstLB, UInt_t lastLB);
+    /// Add the ranges of a GRL XML file
+    StatusCode readXml(const std::string& fileName);
+    /// Build the lookup structure from the ranges added so far
+    void compile();
+
+    /// Whether a lumiblock is good; the list must have been compiled
+    bool accept(UInt_t run, UInt_t lumiBlock) const
+    {
+      if(run != m_lastRun) {
+        if(!findRun(run)) return false;
+      }
+      else if(m_lastIndex == NO_RUN) {
+        return false;
+      }
+      const RunEntry& entry = m_runs[m_lastIndex];
+      const UInt_t bit = lumiBlock - entry.firstLB;
+      return (lumiBlock >= entry.firstLB && bit < entry.nLB &&
+              (m_bits[entry.offset + (bit >> 6)] >> (bit & 63)) & 1);
+    }
+
+    /// Whether the list has no good lumiblocks
+    bool empty() const { return m_ranges.empty(); }
+    /// Number of runs in the compiled list
+    std::size_t nRuns() const { return m_runs.size(); }
+    /// Canonical description of the good lumiblocks, for hashing
+    std::string description() const;
+
+  private:
+    /// A range of good lumiblocks
+    struct Range {
+      UInt_t run, firstLB, lastLB;
+      bool operator<(const Range& rhs) const;
+    }; // struct Range
+
+    /// The bitmap of one run
+    struct RunEntry {
+      UInt_t run;
+      UInt_t firstLB;
+      /// Number of lumiblocks covered by the bitmap
+      UInt_t nLB;
+      /// Index of the first word of the bitmap in m_bits
+      std::size_t offset;
+    }; // struct RunEntry
+
+    /// Look up a run, updating the cache of the last one
+    bool findRun(UInt_t run) const;
+
+    /// Marks the cached run as not found
+    static const std::size_t NO_RUN = static_cast<std::size_t>(-1);
+
+    /// The ranges added so far
+    std::vector<Range> m_ranges;
+    /// The runs, sorted
+    std::vector<RunEntry> m_runs;
+    /// The bitmaps of all runs
+    std::vector<ULong64_t> m_bits;
+    /// Run of the last lookup, and its index in m_runs
+    mutable UInt_t m_lastRun;
+    mutable std::size_t m_lastIndex;
+
+  }; // class GoodRunsList
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_GOODRUNSLIST_H
@@ -0,0 +1,159 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_HISTOGRAMS_H
+#define CPTUTORIALEXAMPLE_HISTOGRAMS_H
+
+// System includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  class HistogramAccumulator;
+  struct OutputConfig;
+
+  /// Fixed-binning histograms filled by the workers of the job
+  ///
+  /// The histograms are booked once, before the event loop. Every worker
+  /// then fills its own HistogramAccumulator, and write() sums them up
+  /// into ROOT histograms at the end of the job. No TH1 exists during the
+  /// loop, so the fills never take a lock.
+  ///
+  class HistogramBook {
+
+  public:
+    /// Binning and layout of one histogram
+    struct Definition {
+      std::string name;
+      std::string title;
+      unsigned int nBins;
+      double low, high;
+      /// Bins per unit of x
+      double scale;
+      /// Position of the histogram in the accumulator buffers [doubles]
+      std::size_t offset;
+    };
+
+    /// Constructor
+    HistogramBook();
+
+    /// Book a histogram, returning its index
+    std::size_t book(const std::string& name, const std::string& title,
+                     unsigned int nBins, double low, double high);
+    /// Index of a histogram by name, or npos if it was not booked
+    std::size_t index(const std::string& name) const;
+
+    /// Number of histograms
+    std::size_t size() const { return m_definitions.size(); }
+    /// Definition of a histogram
+    const Definition& definition(std::size_t i) const
+    { return m_definitions[i]; }
+    /// Size of the accumulator buffers [doubles]
+    std::size_t bufferSize() const { return m_bufferSize; }
+
+    /// Sum up the accumulators and write the histograms to a file
+    StatusCode write(const std::string& fileName,
+                     const std::vector<const HistogramAccumulator*>& acc,
+                     const OutputConfig& output) const;
+
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  private:
+    /// The histograms
+    std::vector<Definition> m_definitions;
+    /// Size of the accumulator buffers [doubles]
+    std::size_t m_bufferSize;
+
+  }; // class HistogramBook
+
+  /// One worker's bin contents of all histograms of a HistogramBook
+  ///
+  /// All histograms live in one buffer, aligned to a cache line, with
+  /// every histogram starting on a line of its own. Each one begins with
+  /// its statistics (entries, sum of w, w^2, w*x, w*x^2), followed by the
+  /// sum of w and w^2 of every bin, next to each other, including the
+  /// underflow and the overflow. As with TH1::Fill(), the statistics
+  /// only count fills inside the axis range.
+  ///
+  class HistogramAccumulator {
+
+  public:
+    /// Constructor with the histograms to fill
+    HistogramAccumulator(const HistogramBook& book);
+
+    /// Fill one value
+    void fill(std::size_t id, double x, double w = 1.)
+    {
+      const Binning& b = m_binning[id];
+      double* h = m_data + b.offset;
+      h[kEntries] += 1.;
+      std::size_t bin = 0;
+      if(x >= b.high) {
+        bin = b.nBins + 1;
+      } else if(x >= b.low) {
+        bin = 1 + static_cast<std::size_t>((x - b.low) * b.scale);
+        if(bin > b.nBins) bin = b.nBins;
+        h[kSumW] += w;
+        h[kSumW2] += w * w;
+        h[kSumWX] += w * x;
+        h[kSumWX2] += w * x * x;
+      }
+      double* c = h + kHeader + 2 * bin;
+      c[0] += w;
+      c[1] += w * w;
+    }
+    /// Fill n values, with weights w, or 1 if w is null
+    void fill(std::size_t id, std::size_t n, const Float_t* x,
+              const Float_t* w = 0);
+
+    /// Add the contents of another accumulator of the same book
+    void add(const HistogramAccumulator& rhs);
+    /// Reset all contents to zero
+    void clear();
+
+    /// The book of the histograms
+    const HistogramBook& book() const { return m_book; }
+    /// Contents of one histogram, laid out as described above
+    const double* data(std::size_t id) const
+    { return m_data + m_binning[id].offset; }
+
+    /// Positions in the header of each histogram
+    enum Header {
+      kEntries = 0,
+      kSumW,
+      kSumW2,
+      kSumWX,
+      kSumWX2,
+      /// Size of the header, one cache line
+      kHeader = 8
+    };
+
+  private:
+    /// The part of the definition needed for filling
+    struct Binning {
+      double low, high, scale;
+      std::size_t nBins;
+      std::size_t offset;
+    };
+
+    /// The histograms
+    const HistogramBook& m_book;
+    /// Local copy of the binning, next to the rest of the worker's data
+    std::vector<Binning> m_binning;
+    /// The memory of the buffer, with room for aligning it
+    std::unique_ptr<double[]> m_memory;
+    /// The aligned buffer
+    double* m_data;
+
+  }; // class HistogramAccumulator
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_HISTOGRAMS_H
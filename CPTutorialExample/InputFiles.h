@@ -0,0 +1,28 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_INPUTFILES_H
+#define CPTUTORIALEXAMPLE_INPUTFILES_H
+
+// System includes
+#include <string>
+#include <vector>
+
+namespace CPTutorial {
+
+  /// Append the files matching a glob pattern to the list
+  ///
+  /// Patterns without wildcards, and URLs (e.g. root://) that can not be
+  /// expanded locally, are added as they are. Returns false if a local
+  /// pattern matches nothing.
+  bool expandInputPattern(const std::string& pattern,
+                          std::vector<std::string>& files);
+
+  /// Append the files named in a text file to the list
+  ///
+  /// The list contains one file name or glob pattern per line. Empty
+  /// lines, and everything after a '#', are ignored.
+  bool readInputFileList(const std::string& listFile,
+                         std::vector<std::string>& files);
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_INPUTFILES_H
@@ -0,0 +1,136 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_JOBCONFIG_H
+#define CPTUTORIALEXAMPLE_JOBCONFIG_H
+
+// System includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "xAODRootAccess/TEvent.h"
+
+// Local includes
+#include "CPTutorialExample/ReadCache.h"
+#include "CPTutorialExample/OutputConfig.h"
+#include "CPTutorialExample/ToolConfig.h"
+
+namespace CPTutorial {
+
+  /// Run-time configuration of the tutorial executable
+  ///
+  /// Filled from the command line by parse(). Options can also be read
+  /// from a file of "name = value" lines with --options. Every option
+  /// defaults to the behaviour of the original single-threaded skeleton.
+  ///
+  struct JobConfig {
+
+    /// Default constructor
+    JobConfig();
+
+    /// Largest run number, the default end of the accepted run range
+    static const UInt_t MAX_RUN = 0xffffffff;
+
+    /// Fill the configuration from the command line
+    ///
+    /// Options may be given as "--name value" or "--name=value".
+    /// Returns false (after printing an error) on malformed input.
+    bool parse(int argc, char* argv[]);
+
+    /// Print the usage message of the executable
+    static void printUsage(const char* appName);
+    /// Name of a TEvent access mode, as used on the command line
+    static const char* accessModeName(xAOD::TEvent::EAuxMode mode);
+
+    /// First entry to process, counted across all input files
+    Long64_t firstEntry() const;
+    /// One past the last entry to process, or -1 to process all entries
+    Long64_t lastEntry() const;
+
+  private:
+    /// Parse a list of arguments; depth counts nested --options files
+    bool parseArguments(const std::vector<std::string>& args,
+                        unsigned int depth);
+
+  public:
+    /// Names of the input xAOD files, with patterns and lists expanded
+    std::vector<std::string> inputFiles;
+    /// Open the next input file in the background
+    bool prefetch;
+    /// Entries to process, counted across all input files; an end of -1
+    /// stands for the end of the input
+    Long64_t rangeBegin, rangeEnd;
+    /// Entries to skip at the beginning of the range
+    Long64_t skipEvents;
+    /// Maximum number of entries to process, -1 for all
+    Long64_t maxEvents;
+    /// Number of worker threads; 1 runs the classic serial loop
+    unsigned int nThreads;
+    /// Number of processes forked after the setup, each processing a
+    /// slice of the entries; 1 for no forking
+    unsigned int nProcesses;
+    /// Number of entries processed together as one block
+    unsigned int blockSize;
+    /// Block sizes to compare, empty for no scan
+    std::vector<unsigned int> blockSizeScan;
+    /// Number of threads decompressing the input ahead of the event
+    /// loop, 0 for none
+    unsigned int pipelineThreads;
+    /// TTreeCache settings for the input files
+    ReadCacheConfig readCache;
+    /// Auxiliary store access mode of the TEvent objects
+    xAOD::TEvent::EAuxMode accessMode;
+    /// Run the job once per access mode and compare the results
+    bool compareAccessModes;
+    /// Give the workers a RecyclingStore for their transient objects
+    bool recycleTransients;
+    /// Runs accepted by the preselection, empty for all
+    std::vector<UInt_t> runList;
+    /// Range of runs accepted by the preselection, [firstRun, lastRun]
+    UInt_t firstRun, lastRun;
+    /// Good-run list XML files applied to data in the preselection
+    std::vector<std::string> grlFiles;
+    /// Directory of the cached event indices, empty for no cache
+    std::string indexCache;
+    /// Systematic variations to run, empty for nominal only
+    std::vector<std::string> systematics;
+    /// The enabled tool stages of the --tool-config file, in order
+    std::vector<ToolConfig> tools;
+    /// Name of the columnar output file, empty for no columnar output
+    std::string columnarOutput;
+    /// Rows each worker buffers before writing them out
+    Long64_t columnarFlushRows;
+    /// Name of the histogram output file, empty for no histograms
+    std::string histogramOutput;
+    /// Name of the file the selected events are copied to, empty for no
+    /// skim
+    std::string skimOutput;
+    /// Compression settings of the output files
+    OutputConfig output;
+    /// Print a message for every processed event
+    bool printEvents;
+    /// Report the progress every this many events, 0 for never
+    Long64_t progressEvery;
+    /// Report the progress at least this often [s], 0 for never
+    double progressInterval;
+    /// Time the phases of every event and write a report
+    bool benchmark;
+    /// Name of the JSON file the benchmark report is written to
+    std::string benchmarkOutput;
+    /// Report the memory use with the progress and at the end of the job
+    bool memoryReport;
+    /// Set up the CP tools only when the first event passes the
+    /// preselection
+    bool lazyInit;
+    /// Report the time taken by the steps before the first event
+    bool startupReport;
+    /// Set when the user asked for the usage message
+    bool showHelp;
+
+  }; // struct JobConfig
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_JOBCONFIG_H
@@ -0,0 +1,82 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_JSONVALUE_H
+#define CPTUTORIALEXAMPLE_JSONVALUE_H
+
+// System includes
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CPTutorial {
+
+  /// A value read from a JSON document
+  ///
+  /// Just enough of JSON for configuration files: objects keep their
+  /// keys sorted, numbers are doubles, and \\u escapes outside of the
+  /// basic multilingual plane are not combined into one character.
+  ///
+  class JsonValue {
+
+  public:
+    /// Types a value can have
+    enum Type {
+      kNull = 0,
+      kBool,
+      kNumber,
+      kString,
+      kArray,
+      kObject
+    };
+
+    /// Constructor, making a null value
+    JsonValue();
+
+    /// Parse a JSON document
+    ///
+    /// Returns false, with a message naming the line of the problem in
+    /// @c error, if the text isn't valid JSON.
+    static bool parse(const std::string& text, JsonValue& result,
+                      std::string& error);
+    /// Read and parse a JSON file, printing an error on failure
+    static bool readFile(const std::string& fileName, JsonValue& result);
+
+    /// Type of the value
+    Type type() const { return m_type; }
+    bool isNull() const { return m_type == kNull; }
+    bool isBool() const { return m_type == kBool; }
+    bool isNumber() const { return m_type == kNumber; }
+    bool isString() const { return m_type == kString; }
+    bool isArray() const { return m_type == kArray; }
+    bool isObject() const { return m_type == kObject; }
+    /// Name of a type, for error messages
+    static const char* typeName(Type type);
+
+    /// The value of a boolean
+    bool boolean() const { return m_bool; }
+    /// The value of a number
+    double number() const { return m_number; }
+    /// The value of a string
+    const std::string& string() const { return m_string; }
+    /// The elements of an array
+    const std::vector<JsonValue>& array() const { return m_array; }
+    /// The members of an object
+    const std::map<std::string, JsonValue>& object() const
+    { return m_object; }
+    /// A member of an object, or 0 if it has no such member
+    const JsonValue* member(const std::string& key) const;
+
+  private:
+    friend class JsonParser;
+
+    Type m_type;
+    bool m_bool;
+    double m_number;
+    std::string m_string;
+    std::vector<JsonValue> m_array;
+    std::map<std::string, JsonValue> m_object;
+
+  }; // class JsonValue
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_JSONVALUE_H
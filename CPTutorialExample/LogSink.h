@@ -0,0 +1,56 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_LOGSINK_H
+#define CPTUTORIALEXAMPLE_LOGSINK_H
+
+// System includes
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CPTutorial {
+
+  /// Buffered, asynchronous sink for log lines
+  ///
+  /// write() only appends the line to an in-memory buffer; a background
+  /// thread writes the buffered lines to the output stream in one go.
+  /// The event loop thus never waits for a terminal or a log file. The
+  /// destructor writes out everything still buffered.
+  ///
+  class AsyncLogSink {
+
+  public:
+    /// Constructor with the stream to write to
+    AsyncLogSink(FILE* out = stderr);
+    /// Destructor, flushes the buffer and stops the writer thread
+    ~AsyncLogSink();
+
+    /// Queue one line, without the trailing newline
+    void write(const std::string& line);
+    /// Queue a message in the format of ROOT's Info()
+    void info(const char* location, const std::string& message);
+
+  private:
+    /// Body of the writer thread
+    void run();
+
+    /// The output stream
+    FILE* m_out;
+    /// Lines waiting to be written
+    std::vector<std::string> m_buffer;
+    /// Protects the buffer and the stop flag
+    std::mutex m_mutex;
+    /// Signals new lines to the writer thread
+    std::condition_variable m_ready;
+    /// Set when the sink is being destroyed
+    bool m_stop;
+    /// The writer thread
+    std::thread m_thread;
+
+  }; // class AsyncLogSink
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_LOGSINK_H
@@ -0,0 +1,177 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_MEMORYACCOUNTING_H
+#define CPTUTORIALEXAMPLE_MEMORYACCOUNTING_H
+
+// System includes
+#include <atomic>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Forward declaration(s)
+class TTree;
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  class ResultWriter;
+  class ResultReader;
+
+  /// Number and size of heap allocations
+  struct AllocationCount {
+    AllocationCount() : nAllocations(0), bytes(0) {}
+    AllocationCount& operator+=(const AllocationCount& rhs)
+    {
+      nAllocations += rhs.nAllocations;
+      bytes += rhs.bytes;
+      return *this;
+    }
+    AllocationCount operator-(const AllocationCount& rhs) const
+    {
+      AllocationCount result = *this;
+      result.nAllocations -= rhs.nAllocations;
+      result.bytes -= rhs.bytes;
+      return result;
+    }
+
+    /// Number of calls to operator new
+    ULong64_t nAllocations;
+    /// Bytes requested from operator new
+    ULong64_t bytes;
+  }; // struct AllocationCount
+
+  /// Allocations made by the calling thread so far
+  ///
+  /// Counted by the replacement operator new of the package, in
+  /// thread-local counters, so counting never touches memory shared
+  /// between threads. Differences of two calls on the same thread give
+  /// the allocations made in between. Only allocations made after
+  /// enableAllocationCounting() are counted.
+  AllocationCount threadAllocations();
+
+  /// Start counting the allocations, for the rest of the process
+  ///
+  /// Until this is called, the replacement operator new only tests a
+  /// flag before calling malloc(), so programs and jobs that don't
+  /// report their memory don't pay for the thread-local counters.
+  void enableAllocationCounting();
+
+  /// Whether the replacement operator new is the one in use
+  ///
+  /// It isn't if another library linked into the job replaces operator
+  /// new too and wins, in which case all counts stay at zero. Needs
+  /// enableAllocationCounting() to have been called.
+  bool allocationCountingActive();
+
+  /// Per-container memory use of one worker, merged at the end of the job
+  ///
+  /// Input containers are measured from the branches of the event tree:
+  /// the uncompressed size of an entry is what xAOD::TEvent holds in
+  /// memory for it once read. Containers made during the event, e.g.
+  /// the shallow copies recorded into the transient store, are measured
+  /// by the allocations made while an AllocationScope of theirs is open.
+  ///
+  class MemoryAccount {
+
+  public:
+    /// Memory use of one container
+    struct Container {
+      Container();
+
+      /// Key of the container
+      std::string name;
+      /// Uncompressed input bytes, summed over the events read
+      double inputBytes;
+      /// Allocations made in the container's AllocationScopes
+      AllocationCount transient;
+    }; // struct Container
+
+    /// Constructor
+    MemoryAccount();
+
+    /// Index of the container with a given key, adding it if needed
+    std::size_t container(const std::string& name);
+    /// Add the allocations made for a container
+    void addTransient(std::size_t index, const AllocationCount& count)
+    { m_containers[index].transient += count; }
+    /// Add the sizes of the containers read from a tree, for the nEvents
+    /// entries of it this worker read
+    void addInput(const TTree& tree, Long64_t nEvents);
+    /// Merge the accounts of another worker, matching containers by key
+    MemoryAccount& operator+=(const MemoryAccount& rhs);
+
+    /// Write the account, to send it to another process
+    void write(ResultWriter& out) const;
+    /// Read an account written by write()
+    bool read(ResultReader& in);
+
+    /// The containers, in the order they were seen
+    const std::vector<Container>& containers() const { return m_containers; }
+    /// Events read from the input
+    Long64_t inputEvents() const { return m_inputEvents; }
+
+    /// Print a table of the per-event sizes, largest first
+    void print(const char* location, Long64_t nEvents) const;
+
+  private:
+    /// The containers
+    std::vector<Container> m_containers;
+    /// Events read from the input
+    Long64_t m_inputEvents;
+
+  }; // class MemoryAccount
+
+  /// Charges the allocations of a scope to a container of a MemoryAccount
+  class AllocationScope {
+
+  public:
+    /// Start counting for a container
+    AllocationScope(MemoryAccount& account, std::size_t container)
+      : m_account(account), m_container(container),
+        m_start(threadAllocations())
+    {}
+    /// Add the allocations made since the constructor
+    ~AllocationScope()
+    { m_account.addTransient(m_container, threadAllocations() - m_start); }
+
+  private:
+    MemoryAccount& m_account;
+    std::size_t m_container;
+    AllocationCount m_start;
+
+  }; // class AllocationScope
+
+  /// Job-wide memory figures for the periodic progress messages
+  ///
+  /// Workers add the allocations of every block with a relaxed atomic
+  /// increment. status() is only called now and then.
+  ///
+  class MemoryMonitor {
+
+  public:
+    /// Constructor
+    MemoryMonitor();
+
+    /// Add the allocations made for n events
+    void add(const AllocationCount& count, Long64_t n)
+    {
+      m_bytes.fetch_add(count.bytes, std::memory_order_relaxed);
+      m_events.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// One line with the RSS, the peak RSS and the bytes per event
+    std::string status() const;
+
+  private:
+    /// Bytes allocated so far
+    std::atomic<ULong64_t> m_bytes;
+    /// Events the allocations were made for
+    std::atomic<Long64_t> m_events;
+
+  }; // class MemoryMonitor
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_MEMORYACCOUNTING_H
@@ -0,0 +1,51 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_OUTPUTCONFIG_H
+#define CPTUTORIALEXAMPLE_OUTPUTCONFIG_H
+
+// System includes
+#include <string>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Forward declaration(s)
+class TFile;
+class TTree;
+
+namespace CPTutorial {
+
+  /// Compression and basket settings of the output files
+  ///
+  /// Applied to every output of the job: the skim, the columnar output
+  /// and the histograms.
+  struct OutputConfig {
+    OutputConfig();
+
+    /// ROOT compression setting, 100 * algorithm + level; -1 keeps
+    /// ROOT's default
+    Int_t compression;
+    /// Basket size of the output branches [bytes]; 0 keeps ROOT's
+    /// default
+    Int_t basketSize;
+    /// Threads of ROOT's implicit multithreading, which compress the
+    /// baskets of a tree in parallel when they are flushed; 0 for none
+    unsigned int compressionThreads;
+  }; // struct OutputConfig
+
+  /// Parse a compression setting
+  ///
+  /// Accepts "ALGORITHM", "ALGORITHM:LEVEL" with an algorithm of zlib,
+  /// lzma, lz4 or zstd, or ROOT's numeric setting. Without a level the
+  /// one of ROOT's presets for the algorithm is used. Returns false on
+  /// malformed input.
+  bool parseCompression(const std::string& value, Int_t& setting);
+
+  /// Set the compression of an output file
+  void configureOutputFile(TFile& file, const OutputConfig& config);
+  /// Set the basket size and the compression of all branches of an
+  /// output tree
+  void configureOutputTree(TTree& tree, const OutputConfig& config);
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_OUTPUTCONFIG_H
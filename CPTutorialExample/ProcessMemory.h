@@ -0,0 +1,19 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_PROCESSMEMORY_H
+#define CPTUTORIALEXAMPLE_PROCESSMEMORY_H
+
+namespace CPTutorial {
+
+  /// Current resident set size of the process [MB]
+  double residentMemory();
+
+  /// Peak resident set size of the process since it started [MB]
+  double peakResidentMemory();
+
+  /// Largest peak resident set size of the child processes waited for
+  /// so far [MB]
+  double childrenPeakResidentMemory();
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_PROCESSMEMORY_H
@@ -0,0 +1,93 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_PROGRESSREPORTER_H
+#define CPTUTORIALEXAMPLE_PROGRESSREPORTER_H
+
+// System includes
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  class AsyncLogSink;
+  class MemoryMonitor;
+
+  /// Rate-limited progress messages for the event loop
+  ///
+  /// Workers call count() once per event, or once per block of events.
+  /// A message with the number of events processed, the current rate
+  /// and the estimated time left is posted to the log sink every
+  /// @c everyEvents events or every @c everySeconds seconds, whichever
+  /// comes first. Between checks count() is a single relaxed atomic
+  /// increment and comparison, so neither the clock nor any formatting
+  /// code is touched per event. count() may be called from several
+  /// threads.
+  ///
+  class ProgressReporter {
+
+  public:
+    /// Constructor
+    ///
+    /// @param sink         Where the messages go
+    /// @param everyEvents  Report every this many events (0: never)
+    /// @param everySeconds Report at least this often (0: never)
+    ProgressReporter(AsyncLogSink& sink, Long64_t everyEvents,
+                     double everySeconds);
+
+    /// Set the number of events expected in the job, for the ETA
+    void setExpected(Long64_t expected) { m_expected = expected; }
+    /// Add the memory figures of a monitor to the messages, null for none
+    void setMemoryMonitor(const MemoryMonitor* memory) { m_memory = memory; }
+
+    /// Count processed events
+    void count(Long64_t n = 1)
+    {
+      const Long64_t done = m_done.fetch_add(n, std::memory_order_relaxed) + n;
+      if(done >= m_nextCheck.load(std::memory_order_relaxed)) check(done);
+    }
+
+    /// Number of events counted so far
+    Long64_t done() const { return m_done.load(std::memory_order_relaxed); }
+
+  private:
+    typedef std::chrono::steady_clock clock;
+
+    /// Decide whether to post a message, and when to check next
+    void check(Long64_t done);
+    /// Event count at which to check next, after done events
+    Long64_t nextCheck(Long64_t done) const;
+
+    /// The log sink
+    AsyncLogSink& m_sink;
+    /// Event interval between messages
+    Long64_t m_everyEvents;
+    /// Time interval between messages [s]
+    double m_everySeconds;
+    /// Events expected in the job, or -1 if not known
+    std::atomic<Long64_t> m_expected;
+    /// Memory figures added to the messages, if any
+    const MemoryMonitor* m_memory;
+
+    /// Events counted so far
+    std::atomic<Long64_t> m_done;
+    /// Event count at which check() is called next
+    std::atomic<Long64_t> m_nextCheck;
+
+    /// Protects the members below
+    std::mutex m_mutex;
+    /// Start of the job
+    clock::time_point m_start;
+    /// Time of the last message
+    clock::time_point m_lastReport;
+    /// Event count of the next message due by count
+    Long64_t m_nextReport;
+
+  }; // class ProgressReporter
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_PROGRESSREPORTER_H
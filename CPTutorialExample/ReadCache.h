@@ -0,0 +1,79 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_READCACHE_H
+#define CPTUTORIALEXAMPLE_READCACHE_H
+
+// System includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Forward declaration(s)
+class TFile;
+class TTree;
+
+namespace CPTutorial {
+
+  /// TTreeCache settings for the input files
+  struct ReadCacheConfig {
+    ReadCacheConfig();
+
+    /// Cache size in bytes; 0 disables the cache, -1 keeps TEvent's default
+    Long64_t cacheSize;
+    /// Entries of the learning phase; 0 caches only the registered
+    /// branches, -1 keeps ROOT's default
+    Long64_t learnEntries;
+    /// Containers whose branches are registered in the cache up front
+    std::vector<std::string> branches;
+  }; // struct ReadCacheConfig
+
+  /// I/O statistics of the input files
+  struct ReadStats {
+    ReadStats();
+    ReadStats& operator+=(const ReadStats& rhs);
+
+    /// Add the statistics of a file that is about to be closed
+    void addFile(const TFile& file, const TTree* tree);
+
+    /// Fraction of the bytes read that went through the TTreeCache
+    double cacheHitRatio() const;
+
+    /// Number of input files
+    Long64_t nFiles;
+    /// Total bytes read
+    Long64_t bytesRead;
+    /// Total number of read calls
+    Long64_t readCalls;
+    /// Bytes read through the cache
+    Long64_t cacheBytesRead;
+    /// Bytes read directly, missing the cache
+    Long64_t noCacheBytesRead;
+  }; // struct ReadStats
+
+  /// Set up the TTreeCache of an input tree
+  ///
+  /// Needs to be called after xAOD::TEvent::readFrom(), which sets up a
+  /// cache of its own. Each container named in the configuration is
+  /// registered with its interface, static and dynamic aux branches.
+  /// The length of the learning phase is set by setCacheLearnEntries().
+  void configureReadCache(TTree& tree, const ReadCacheConfig& config);
+
+  /// Set the number of entries of the cache learning phase
+  ///
+  /// This is a process-wide setting of ROOT, used by every TTreeCache
+  /// created afterwards. It has to be made once, before the first input
+  /// file is opened and before the workers start their threads.
+  void setCacheLearnEntries(const ReadCacheConfig& config);
+
+  /// Decompress the baskets of the input caches in parallel
+  ///
+  /// The TTreeCache of every input file opened afterwards unzips the
+  /// baskets of the cluster it read on ROOT's implicit multi-threading
+  /// pool, ahead of the entries being loaded. The pool has to be started
+  /// with ROOT::EnableImplicitMT() before the first file is opened.
+  void enableParallelUnzip();
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_READCACHE_H
@@ -0,0 +1,209 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_RECYCLINGSTORE_H
+#define CPTUTORIALEXAMPLE_RECYCLINGSTORE_H
+
+// System includes
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace CPTutorial {
+
+  /// Bump allocator for per-event scratch memory
+  ///
+  /// Memory is handed out from large blocks and only given back all at
+  /// once by reset(), which keeps the blocks for the next event. After
+  /// the first few events no allocation reaches the system allocator.
+  /// Only trivially destructible objects can live in the arena.
+  ///
+  class MonotonicArena {
+
+  public:
+    /// Constructor with the size of the first block
+    MonotonicArena(std::size_t blockSize = 1 << 16);
+
+    /// Allocate raw memory
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /// Allocate an uninitialised array of trivially destructible objects
+    template<typename T>
+    T* allocateArray(std::size_t n)
+    {
+      static_assert(std::is_trivially_destructible<T>::value,
+                    "Only trivially destructible types can use the arena");
+      return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /// Release everything allocated since the last reset
+    void reset();
+
+    /// Bytes currently allocated
+    std::size_t used() const;
+    /// Bytes reserved in blocks
+    std::size_t capacity() const;
+
+  private:
+    /// One memory block
+    struct Block {
+      std::unique_ptr<char[]> data;
+      std::size_t size;
+    };
+
+    /// The blocks, the last one is being filled
+    std::vector<Block> m_blocks;
+    /// Index of the block being filled
+    std::size_t m_current;
+    /// Bytes used in the current block
+    std::size_t m_offset;
+    /// Bytes used in the blocks before the current one
+    std::size_t m_usedBefore;
+    /// Size of the next block to allocate
+    std::size_t m_blockSize;
+
+  }; // class MonotonicArena
+
+  /// How RecyclingStore resets an object at the end of an event
+  ///
+  /// The default calls clear(). STL containers keep their capacity with
+  /// it, but a DataVector owning its elements deletes them, so the next
+  /// event allocates them again from the heap; only the container itself
+  /// is reused. Specialise it for types that can keep more, like
+  /// ShallowCopyCache does.
+  template<typename T>
+  struct Recycler {
+    static void reset(T& obj) { obj.clear(); }
+  };
+
+  /// Statistics of a RecyclingStore
+  struct RecyclingStats {
+    RecyclingStats();
+    RecyclingStats& operator+=(const RecyclingStats& rhs);
+
+    /// Objects created, because no recycled one was available
+    unsigned long long nCreated;
+    /// Objects handed out again after being recycled
+    unsigned long long nReused;
+    /// Largest arena capacity seen [bytes]
+    std::size_t arenaCapacity;
+  }; // struct RecyclingStats
+
+  /// Transient store that recycles its objects across events
+  ///
+  /// An alternative to recording freshly allocated objects into
+  /// xAOD::TStore, which deletes them all in clear() only for the next
+  /// event to allocate them again. Objects are created on first use of
+  /// a type/key pair and kept for the whole job; clear() merely resets
+  /// them with Recycler<T>::reset(). What is reused is the object in its
+  /// slot, not the memory it allocates itself. The arena is separate
+  /// scratch memory for per-event arrays, which clear() rewinds. The
+  /// store keeps ownership of everything it hands out.
+  ///
+  class RecyclingStore {
+
+  public:
+    /// Constructor
+    RecyclingStore();
+    /// Destructor
+    ~RecyclingStore();
+
+    /// Get the object of a type/key pair for the current event
+    ///
+    /// Returns a reset object from a previous event if there is one,
+    /// and a default constructed one otherwise. The object stays valid
+    /// until the next clear().
+    template<typename T>
+    T* acquire(const std::string& key);
+
+    /// Retrieve an object acquired in the current event
+    template<typename T>
+    bool retrieve(const T*& obj, const std::string& key) const;
+
+    /// Whether an object was acquired for the key in the current event
+    bool contains(const std::string& key) const;
+
+    /// The per-event arena, rewound by clear()
+    MonotonicArena& arena() { return m_arena; }
+
+    /// Reset all objects of the event and rewind the arena
+    void clear();
+
+    /// Statistics
+    RecyclingStats stats() const;
+
+  private:
+    /// Type-erased owner of one recycled object
+    struct SlotBase {
+      virtual ~SlotBase() {}
+      virtual void reset() = 0;
+      virtual const std::type_info& type() const = 0;
+      /// Whether the object was acquired in the current event
+      bool live;
+    };
+    template<typename T>
+    struct Slot : public SlotBase {
+      Slot() : object(new T()) { live = false; }
+      virtual void reset() { Recycler<T>::reset(*object); }
+      virtual const std::type_info& type() const { return typeid(T); }
+      std::unique_ptr<T> object;
+    };
+
+    /// Report an acquire() with the wrong type
+    void typeMismatch(const std::string& key, const std::type_info& requested,
+                      const std::type_info& stored) const;
+
+    /// The objects, by key
+    std::unordered_map<std::string, std::unique_ptr<SlotBase> > m_slots;
+    /// The slots acquired in the current event
+    std::vector<SlotBase*> m_live;
+    /// Scratch memory of the current event
+    MonotonicArena m_arena;
+    /// Counters
+    RecyclingStats m_stats;
+
+  }; // class RecyclingStore
+
+  template<typename T>
+  T* RecyclingStore::acquire(const std::string& key)
+  {
+    std::unique_ptr<SlotBase>& slot = m_slots[key];
+    if(!slot) {
+      slot.reset(new Slot<T>());
+      ++m_stats.nCreated;
+    }
+    else if(slot->type() != typeid(T)) {
+      typeMismatch(key, typeid(T), slot->type());
+      return 0;
+    }
+    else if(!slot->live) {
+      ++m_stats.nReused;
+    }
+    if(!slot->live) {
+      slot->live = true;
+      m_live.push_back(slot.get());
+    }
+    return static_cast<Slot<T>*>(slot.get())->object.get();
+  }
+
+  template<typename T>
+  bool RecyclingStore::retrieve(const T*& obj, const std::string& key) const
+  {
+    std::unordered_map<std::string,
+                       std::unique_ptr<SlotBase> >::const_iterator itr =
+      m_slots.find(key);
+    if(itr == m_slots.end() || !itr->second->live) return false;
+    if(itr->second->type() != typeid(T)) {
+      typeMismatch(key, typeid(T), itr->second->type());
+      return false;
+    }
+    obj = static_cast<const Slot<T>*>(itr->second.get())->object.get();
+    return true;
+  }
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_RECYCLINGSTORE_H
@@ -0,0 +1,117 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_RESULTSTREAM_H
+#define CPTUTORIALEXAMPLE_RESULTSTREAM_H
+
+// System includes
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace CPTutorial {
+
+  /// Writes results into a byte buffer, to be sent to another process
+  ///
+  /// Only meant for a process forked from the same executable: values
+  /// are copied as they are in memory, without any conversion. Read
+  /// them back with a ResultReader, in the same order.
+  ///
+  class ResultWriter {
+
+  public:
+    /// Append a trivially copyable value
+    template<typename T>
+    void put(const T& value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be written");
+      m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    /// Append a string, with its length
+    void put(const std::string& value)
+    {
+      put<unsigned long long>(value.size());
+      m_data.append(value);
+    }
+    /// Append a vector of trivially copyable values, with its length
+    template<typename T>
+    void put(const std::vector<T>& values)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be written");
+      put<unsigned long long>(values.size());
+      if(!values.empty()) {
+        m_data.append(reinterpret_cast<const char*>(values.data()),
+                      values.size() * sizeof(T));
+      }
+    }
+
+    /// The buffer written so far
+    const std::string& data() const { return m_data; }
+
+  private:
+    std::string m_data;
+
+  }; // class ResultWriter
+
+  /// Reads the results written by a ResultWriter
+  ///
+  /// Every get() returns false, leaving the value unchanged, once it
+  /// would read past the end of the buffer.
+  ///
+  class ResultReader {
+
+  public:
+    /// Constructor with the buffer to read, which has to outlive it
+    explicit ResultReader(const std::string& data)
+      : m_data(data), m_offset(0) {}
+
+    /// Read a trivially copyable value
+    template<typename T>
+    bool get(T& value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be read");
+      if(m_data.size() - m_offset < sizeof(T)) return false;
+      std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+      m_offset += sizeof(T);
+      return true;
+    }
+    /// Read a string
+    bool get(std::string& value)
+    {
+      unsigned long long size = 0;
+      if(!get(size) || m_data.size() - m_offset < size) return false;
+      value.assign(m_data, m_offset, size);
+      m_offset += size;
+      return true;
+    }
+    /// Read a vector of trivially copyable values
+    template<typename T>
+    bool get(std::vector<T>& values)
+    {
+      unsigned long long size = 0;
+      if(!get(size) || (m_data.size() - m_offset) / sizeof(T) < size) {
+        return false;
+      }
+      values.resize(size);
+      if(size > 0) {
+        std::memcpy(values.data(), m_data.data() + m_offset,
+                    size * sizeof(T));
+      }
+      m_offset += size * sizeof(T);
+      return true;
+    }
+
+    /// Whether everything was read
+    bool atEnd() const { return m_offset == m_data.size(); }
+
+  private:
+    const std::string& m_data;
+    std::size_t m_offset;
+
+  }; // class ResultReader
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_RESULTSTREAM_H
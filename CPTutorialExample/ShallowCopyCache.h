@@ -0,0 +1,105 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_SHALLOWCOPYCACHE_H
+#define CPTUTORIALEXAMPLE_SHALLOWCOPYCACHE_H
+
+// System includes
+#include <memory>
+#include <string>
+#include <utility>
+
+// EDM includes
+#include "AthLinks/DataLink.h"
+#include "xAODCore/ShallowCopy.h"
+#include "xAODCore/ShallowAuxContainer.h"
+
+// Local includes
+#include "CPTutorialExample/RecyclingStore.h"
+
+namespace CPTutorial {
+
+  /// Shallow copy of an input container that is kept across events
+  ///
+  /// xAOD::shallowCopyContainer() creates a new container, one new
+  /// element per input object and a new xAOD::ShallowAuxContainer every
+  /// event. This class keeps the copy, and for the following events
+  /// rebind() points its aux container at the new input, as long as the
+  /// input has as many objects as before. The variable vectors the aux
+  /// container holds for overridden and decorated variables then keep
+  /// their contents' memory from event to event. A ShallowAuxContainer
+  /// can't be resized, so when the object count changes the copy is
+  /// made again with xAOD::shallowCopyContainer().
+  ///
+  /// Values written in one event are not cleared for the next one, so
+  /// every variable a tool overrides has to be written for all objects
+  /// of every event. That is how CP calibration tools work; decorations
+  /// only set for some objects need a fresh shallow copy instead.
+  ///
+  template<class CONT>
+  class ShallowCopyCache {
+
+  public:
+    /// Make the copy shadow a new input container
+    ///
+    /// Returns the shallow copy, a null pointer if the input has no aux
+    /// store that could be linked to.
+    CONT* rebind(const CONT& input)
+    {
+      const SG::IConstAuxStore* inputStore = input.getConstStore();
+      if(!inputStore) return 0;
+
+      // First event, or a different number of objects: make the copy
+      // the usual way
+      if(!m_copy || m_copy->size() != input.size()) {
+        m_copy.reset();
+        m_aux.reset();
+        std::pair<CONT*, xAOD::ShallowAuxContainer*> copy =
+          xAOD::shallowCopyContainer(input);
+        m_copy.reset(copy.first);
+        m_aux.reset(copy.second);
+        return m_copy.get();
+      }
+
+      // Point the aux container at the new parent
+      m_aux->setParent(DataLink<SG::IConstAuxStore>(inputStore));
+
+      // Setting the store again drops the cached variable pointers of
+      // the previous parent
+      m_copy->setStore(m_aux.get());
+      return m_copy.get();
+    }
+
+    /// The shallow copy, valid after the first rebind()
+    CONT* container() const { return m_copy.get(); }
+    /// The aux container of the shallow copy
+    xAOD::ShallowAuxContainer* auxContainer() const { return m_aux.get(); }
+
+  private:
+    /// The copy container
+    std::unique_ptr<CONT> m_copy;
+    /// Its aux container
+    std::unique_ptr<xAOD::ShallowAuxContainer> m_aux;
+
+  }; // class ShallowCopyCache
+
+  /// Shallow copy caches are rebound, not reset, between events
+  template<class CONT>
+  struct Recycler<ShallowCopyCache<CONT> > {
+    static void reset(ShallowCopyCache<CONT>&) {}
+  };
+
+  /// Get a shallow copy of an input container, reused across events
+  ///
+  /// Keeps one ShallowCopyCache per key in the worker's RecyclingStore.
+  /// Note that the copy is owned by the RecyclingStore, so it can't be
+  /// recorded into xAOD::TStore.
+  template<class CONT>
+  CONT* recycledShallowCopy(RecyclingStore& store, const CONT& input,
+                            const std::string& key)
+  {
+    ShallowCopyCache<CONT>* cache = store.acquire<ShallowCopyCache<CONT> >(key);
+    return cache ? cache->rebind(input) : 0;
+  }
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_SHALLOWCOPYCACHE_H
@@ -0,0 +1,83 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_SKIMWRITER_H
+#define CPTUTORIALEXAMPLE_SKIMWRITER_H
+
+// System includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "RtypesCore.h"
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/OutputConfig.h"
+
+// Forward declaration(s)
+class TFile;
+class TTree;
+
+namespace CPTutorial {
+
+  /// Copy of the input events passing the selection, unmodified
+  ///
+  /// After each input file the event loop hands over the entries that
+  /// passed. The writer reads them from its own handle of the file, so
+  /// it never touches the branches TEvent reads from. Files kept in
+  /// full are cloned basket by basket, without decompressing anything.
+  /// ROOT can only copy whole baskets, and the baskets of different
+  /// branches end at different entries, so files kept only in part have
+  /// their selected entries read and filled again. The MetaData tree of
+  /// every file is always cloned in full. Copied baskets keep their
+  /// compression and size, so with an explicit compression or basket
+  /// size in the OutputConfig every entry is filled again.
+  ///
+  class SkimWriter {
+
+  public:
+    /// Constructor
+    SkimWriter();
+    /// Destructor
+    ~SkimWriter();
+
+    /// Open the output file
+    StatusCode open(const std::string& fileName, const OutputConfig& output);
+    /// Append the given entries of an input file, in any order, and its
+    /// metadata if asked to
+    StatusCode addFile(const std::string& fileName,
+                       std::vector<Long64_t> entries,
+                       bool copyMetaData);
+    /// Write the trees and close the file
+    StatusCode close();
+
+    /// Entries written so far
+    Long64_t entries() const { return m_entriesWritten; }
+
+  private:
+    /// Whether trees kept in full can be copied basket by basket
+    bool copyBaskets() const
+    { return m_output.compression < 0 && m_output.basketSize <= 0; }
+    /// Append a tree to its copy in the output, creating it if needed
+    StatusCode cloneTree(TTree& input, TTree*& output);
+
+    /// Compression settings of the output
+    OutputConfig m_output;
+    /// The output file
+    std::unique_ptr<TFile> m_file;
+    /// The output event tree, owned by the file
+    TTree* m_tree;
+    /// The output metadata tree, owned by the file
+    TTree* m_metaTree;
+    /// Entries written so far
+    Long64_t m_entriesWritten;
+    /// Input files seen so far, and the ones cloned basket by basket
+    unsigned int m_nFiles, m_nFastFiles;
+
+  }; // class SkimWriter
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_SKIMWRITER_H
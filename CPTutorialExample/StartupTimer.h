@@ -0,0 +1,58 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_STARTUPTIMER_H
+#define CPTUTORIALEXAMPLE_STARTUPTIMER_H
+
+// System includes
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CPTutorial {
+
+  /// Times the steps between the start of the process and the first event
+  ///
+  /// Each mark() ends a step, which started with the previous mark, or
+  /// with the construction of the timer. The time the process spent
+  /// before that, loading its libraries and their dictionaries, is taken
+  /// from the operating system where it can be. mark() may be called from
+  /// several threads.
+  ///
+  class StartupTimer {
+
+  public:
+    /// Constructor, starting the first step
+    StartupTimer();
+
+    /// End the current step
+    void mark(const std::string& step);
+    /// End the current step, unless a step of the same name was ended
+    /// already
+    void markOnce(const std::string& step);
+
+    /// Time from the start of the process to the construction, or a
+    /// negative value if it is not known [s]
+    double beforeStart() const { return m_beforeStart; }
+    /// Print the steps, with the time to the end of the last one
+    void print(const char* location) const;
+
+  private:
+    typedef std::chrono::steady_clock clock;
+
+    /// Protects the members below
+    mutable std::mutex m_mutex;
+    /// Time from the start of the process to the construction [s]
+    double m_beforeStart;
+    /// Construction time
+    clock::time_point m_start;
+    /// End of the last step
+    clock::time_point m_last;
+    /// The steps and their durations [s]
+    std::vector<std::pair<std::string, double> > m_steps;
+
+  }; // class StartupTimer
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_STARTUPTIMER_H
@@ -0,0 +1,130 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_STATICPIPELINE_H
+#define CPTUTORIALEXAMPLE_STATICPIPELINE_H
+
+// System includes
+#include <cstddef>
+#include <typeinfo>
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  /// A chain of per-event stages fixed at compile time
+  ///
+  /// The compile-time counterpart of the ToolStage chain of the tool
+  /// configuration, for a frozen production setup. Every stage is a
+  /// plain class, held by value, with
+  ///
+  ///   StatusCode initialize();
+  ///   bool execute(CONTEXT& context);
+  ///
+  /// where execute() returns false on failure. None of it is virtual,
+  /// so the compiler sees the whole chain and can inline it into the
+  /// event loop. Between the stages there is only the test of a bool;
+  /// a StatusCode is made once, by the caller, from the result of the
+  /// whole chain. E.g.
+  ///
+  ///   typedef StaticPipeline<JetCalibStage, JetSelectionStage> Chain;
+  ///   Chain chain;
+  ///   CPT_RETURN_CHECK( APP_NAME, chain.initialize() );
+  ///   ...
+  ///   if(!chain.execute(context)) {
+  ///     Error(APP_NAME, "Stage %s failed", chain.failedStageName());
+  ///   }
+  ///
+  template<typename... STAGES>
+  class StaticPipeline;
+
+  /// The end of the chain
+  template<>
+  class StaticPipeline<> {
+
+    template<typename... OTHERS> friend class StaticPipeline;
+
+  public:
+    /// Number of stages
+    static const std::size_t size = 0;
+
+    StaticPipeline() : m_failedRemaining(0) {}
+
+    StatusCode initialize() { return StatusCode::SUCCESS; }
+    template<typename CONTEXT>
+    bool execute(CONTEXT&) { return true; }
+
+    /// Index of the stage that failed last, size if none did
+    std::size_t failedStage() const { return 0; }
+    /// Type name of the stage that failed last
+    const char* failedStageName() const { return "none"; }
+
+  private:
+    /// Name of the stage at an index counted from this link
+    static const char* stageName(std::size_t) { return "none"; }
+
+    /// Number of stages from the one that failed last to the end of the
+    /// chain, 0 if none failed
+    std::size_t m_failedRemaining;
+
+  }; // class StaticPipeline<>
+
+  /// One link of the chain: a stage, followed by the others
+  template<typename FIRST, typename... REST>
+  class StaticPipeline<FIRST, REST...> : private StaticPipeline<REST...> {
+
+    typedef StaticPipeline<REST...> Rest;
+    template<typename... OTHERS> friend class StaticPipeline;
+
+  public:
+    /// Number of stages
+    static const std::size_t size = Rest::size + 1;
+
+    /// Initialize the stages in order, stopping at the first failure
+    StatusCode initialize()
+    {
+      if(m_stage.initialize().isFailure()) return StatusCode::FAILURE;
+      return Rest::initialize();
+    }
+
+    /// Run the stages in order, stopping at the first failure
+    template<typename CONTEXT>
+    bool execute(CONTEXT& context)
+    {
+      if(CPT_UNLIKELY(!m_stage.execute(context))) {
+        this->m_failedRemaining = size;
+        return false;
+      }
+      return Rest::execute(context);
+    }
+
+    /// The first stage
+    FIRST& first() { return m_stage; }
+    /// The chain of the other stages
+    Rest& rest() { return *this; }
+
+    /// Index of the stage that failed last, size if none did
+    std::size_t failedStage() const
+    {
+      const std::size_t remaining = this->m_failedRemaining;
+      return remaining ? size - remaining : size;
+    }
+    /// Type name of the stage that failed last
+    const char* failedStageName() const { return stageName(failedStage()); }
+
+  private:
+    /// Name of the stage at an index counted from this link
+    static const char* stageName(std::size_t index)
+    {
+      return index == 0 ? typeid(FIRST).name() : Rest::stageName(index - 1);
+    }
+
+    FIRST m_stage;
+
+  }; // class StaticPipeline<FIRST, REST...>
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_STATICPIPELINE_H
@@ -0,0 +1,128 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_SYSTEMATICSDRIVER_H
+#define CPTUTORIALEXAMPLE_SYSTEMATICSDRIVER_H
+
+// System includes
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+#include "PATInterfaces/SystematicSet.h"
+
+// Forward declaration(s)
+namespace CP {
+  class ISystematicsTool;
+}
+
+namespace CPTutorial {
+
+  /// Runs every systematic variation within the same pass over an event
+  ///
+  /// Instead of one pass over the input per systematic, each entry is
+  /// read once and the CP tools are then run once per systematic set.
+  /// The input containers are shared by all variations; what differs
+  /// per variation are the shallow copies made from them, recorded
+  /// under the keys given by containerKey(). The nominal set is always
+  /// the first one.
+  ///
+  /// Tools can be registered together with the container they calibrate.
+  /// A variation that affects none of a container's tools, like a muon
+  /// scale variation for jets, leaves the container as it is: its key
+  /// then refers to the nominal copy, and needsUpdate() tells that it
+  /// need not be rebuilt. Variations affecting nothing at all are
+  /// skipped entirely.
+  ///
+  class SystematicsDriver {
+
+  public:
+    /// Constructor
+    SystematicsDriver();
+
+    /// Register a tool that is switched between the variations
+    void addTool(CP::ISystematicsTool* tool);
+    /// Register a tool calibrating the objects of a container
+    ///
+    /// Returns the index of the container, for the faster overloads of
+    /// needsUpdate() and containerKey().
+    std::size_t addTool(CP::ISystematicsTool* tool,
+                        const std::string& container);
+
+    /// Choose the systematic sets to run
+    ///
+    /// An empty list runs only the nominal set; "all" runs every
+    /// variation recommended by the registered tools (at +/-1 sigma for
+    /// continuous ones); otherwise the list holds variation names, like
+    /// "MUON_SCALE__1up", each run as its own set.
+    StatusCode initialize(const std::vector<std::string>& names);
+
+    /// Number of systematic sets, including the nominal one
+    std::size_t size() const { return m_systematics.size(); }
+    /// A systematic set
+    const CP::SystematicSet& systematic(std::size_t index) const
+    { return m_systematics[index]; }
+    /// Whether a set is the nominal one
+    bool isNominal(std::size_t index) const
+    { return m_systematics[index].empty(); }
+
+    /// Whether a systematic set affects any registered tool
+    bool affectsAny(std::size_t index) const { return m_affectsAny[index]; }
+    /// Whether a container has to be rebuilt for a systematic set
+    ///
+    /// False if the set leaves the container unchanged with respect to
+    /// an earlier set, usually the nominal one. Unregistered containers
+    /// always need an update.
+    bool needsUpdate(std::size_t container, std::size_t index) const
+    { return m_containers[container].source[index] == index; }
+    bool needsUpdate(const std::string& container, std::size_t index) const;
+    /// Index of a registered container, npos if it's not registered
+    std::size_t findContainer(const std::string& key) const;
+
+    /// Switch all registered tools to a systematic set
+    StatusCode apply(std::size_t index);
+
+    /// Key of a container for a systematic set
+    ///
+    /// The base key for the nominal set, "<base>_<systematic>" for the
+    /// others. The keys are built once and cached, so calling this per
+    /// event does not allocate. For a registered container that is not
+    /// affected by the set, this is the key of the copy it shares.
+    const std::string& containerKey(std::size_t container,
+                                    std::size_t index) const
+    { const Container& c = m_containers[container];
+      return c.keys[c.source[index]]; }
+    const std::string& containerKey(const std::string& base,
+                                    std::size_t index);
+
+  private:
+    /// A container whose calibration depends on some of the tools
+    struct Container {
+      /// Base key of the container
+      std::string key;
+      /// Tools calibrating it
+      std::vector<CP::ISystematicsTool*> tools;
+      /// Per set, the index of the set whose copy is used
+      std::vector<std::size_t> source;
+      /// Per set, the key of the container
+      std::vector<std::string> keys;
+    }; // struct Container
+
+    /// The registered tools
+    std::vector<CP::ISystematicsTool*> m_tools;
+    /// The registered containers
+    std::vector<Container> m_containers;
+    /// The systematic sets to run, nominal first
+    std::vector<CP::SystematicSet> m_systematics;
+    /// Per set, whether it affects any of the tools
+    std::vector<bool> m_affectsAny;
+    /// Index of the set the tools are configured for, -1 if none
+    long m_current;
+    /// Cached container keys, per base key and systematic set
+    std::unordered_map<std::string, std::vector<std::string> > m_keys;
+
+  }; // class SystematicsDriver
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_SYSTEMATICSDRIVER_H
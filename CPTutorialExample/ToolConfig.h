@@ -0,0 +1,86 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_TOOLCONFIG_H
+#define CPTUTORIALEXAMPLE_TOOLCONFIG_H
+
+// System includes
+#include <set>
+#include <string>
+#include <vector>
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// Local includes
+#include "CPTutorialExample/JsonValue.h"
+
+namespace CPTutorial {
+
+  /// Configuration of one tool stage of the event loop
+  ///
+  /// Read from the "tools" array of a JSON file given with
+  /// --tool-config. Each element looks like
+  ///
+  ///   { "type": "EventInfoScale", "name": "MuScale", "enabled": true,
+  ///     "container": "EventInfo",
+  ///     "properties": { "scale": 0.9174 } }
+  ///
+  /// where only "type" is required, and "container" for stages that
+  /// read a container, so that they run on its systematic variations.
+  /// The stages run in the order of the array. The getters leave the
+  /// value they are given unchanged if the property is not set, and
+  /// fail if it is set to the wrong type, so that ToolStage::initialize()
+  /// can stop the job. They also remember which properties were asked
+  /// for, so that misspelt ones are caught after initialize().
+  ///
+  struct ToolConfig {
+    ToolConfig();
+
+    /// Read the stages of a JSON configuration file
+    ///
+    /// Disabled stages are dropped, so that the workers never construct
+    /// them. Returns false after printing an error on invalid input,
+    /// including types no stage was registered for.
+    static bool readFile(const std::string& fileName,
+                         std::vector<ToolConfig>& tools);
+
+    /// Whether a property was set
+    bool has(const std::string& property) const;
+    /// The properties set, but not asked for by has() or the getters
+    std::vector<std::string> unreadProperties() const;
+    /// Get a string property
+    StatusCode getString(const std::string& property,
+                         std::string& value) const;
+    /// Get a number property
+    StatusCode getDouble(const std::string& property, double& value) const;
+    /// Get a boolean property
+    StatusCode getBool(const std::string& property, bool& value) const;
+    /// Get a list of strings property
+    StatusCode getStrings(const std::string& property,
+                          std::vector<std::string>& value) const;
+    /// Get a list of numbers property
+    StatusCode getDoubles(const std::string& property,
+                          std::vector<double>& value) const;
+
+    /// Registered type of the stage
+    std::string type;
+    /// Instance name, used for the tool and in messages
+    std::string name;
+    /// Whether the stage runs at all
+    bool enabled;
+    /// Key of the container the stage calibrates or reads, empty for
+    /// none
+    std::string container;
+    /// The properties, a JSON object
+    JsonValue properties;
+
+  private:
+    /// Look up a property, remembering that it was asked for
+    const JsonValue* findProperty(const std::string& name) const;
+
+    /// The properties asked for so far
+    mutable std::set<std::string> m_read;
+  }; // struct ToolConfig
+
+} // namespace CPTutorial
+
+#endif // CPTUTORIALEXAMPLE_TOOLCONFIG_H
@@ -0,0 +1,129 @@
+// Dear emacs, this is -*- c++ -*-
+#ifndef CPTUTORIALEXAMPLE_TOOLSTAGE_H
+#define CPTUTORIALEXAMPLE_TOOLSTAGE_H
+
+// System includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// Infrastructure includes
+#include "AsgTools/StatusCode.h"
+
+// EDM includes
+#include "xAODEventInfo/EventInfo.h"
+
+// Local includes
+#include "CPTutorialExample/ToolConfig.h"
+
+// Forward declarations
+namespace CP {
+  class ISystematicsTool;
+}
+namespace xAOD {
+  class TEvent;
+  class TStore;
+}
+
+namespace CPTutorial {
+
+  // Forward declaration(s)
+  struct EventBlock;
+  class RecyclingStore;
+  class SystematicsDriver;
+  class EventCursor;
+
+  /// What a tool stage gets to see of the current event
+  struct ToolContext {
+    /// The input event
+    xAOD::TEvent& event;
+    /// The input event for ContainerHandle lookups
+    const EventCursor& cursor;
+    /// The transient store of the worker
+    xAOD::TStore& store;
+    /// The recycling store of the worker, if requested
+    RecyclingStore* recycling;
+    /// The systematics driver, already switched to the set "sys"
+    SystematicsDriver& systematics;
+    /// The systematic set being run
+    std::size_t sys;
+    /// The EventInfo object of the event
+    const xAOD::EventInfo& eventInfo;
+    /// The block the event is part of, null if the events are processed
+    /// one at a time
+    EventBlock* block;
+  }; // struct ToolContext
+
+  /// One step of the tool chain, set up from a ToolConfig
+  ///
+  /// The worker creates the enabled stages of the configuration in
+  /// order, through ToolStageFactory, and calls execute() for the
+  /// systematic sets of every event that change its result. Each stage
+  /// wraps a CP tool, setting its properties from the configuration in
+  /// initialize(); properties it didn't ask for stop the job. A stage
+  /// with systematics of its own runs for every set that affects its
+  /// container. One without runs for the nominal set, and for every set
+  /// that varies the container it reads, which it has to name in the
+  /// configuration if readsContainer() is true. With --block-size above
+  /// 1, executeBlock() is called once all events of a block were
+  /// executed, for stages that work on the whole block.
+  ///
+  class ToolStage {
+
+  public:
+    /// Destructor
+    virtual ~ToolStage() {}
+
+    /// Create and configure the tool
+    virtual StatusCode initialize(const ToolConfig& config) = 0;
+    /// Run the tool for the current event and systematic set
+    virtual StatusCode execute(const ToolContext& context) = 0;
+    /// Run over what execute() gathered from the events of a block
+    virtual StatusCode executeBlock(EventBlock& /*block*/)
+    { return StatusCode::SUCCESS; }
+    /// The tool to register with the SystematicsDriver, if any
+    virtual CP::ISystematicsTool* systematicsTool() { return 0; }
+    /// Whether the stage reads the container of its configuration, and
+    /// so has to run on its variations
+    virtual bool readsContainer() const { return false; }
+
+  }; // class ToolStage
+
+  /// Registry of the tool stage types, by name
+  ///
+  /// Stage types register themselves with CPT_REGISTER_TOOL_STAGE, at
+  /// library load time, so that the configuration can use any type
+  /// linked into the job.
+  ///
+  class ToolStageFactory {
+
+  public:
+    /// Function creating a stage
+    typedef ToolStage* (*Creator)();
+
+    /// Register a stage type, returning false if the name was taken
+    static bool add(const std::string& type, Creator creator);
+    /// Whether a stage type was registered
+    static bool has(const std::string& type);
+    /// Create a stage of a registered type, or null for unknown types
+    static std::unique_ptr<ToolStage> create(const std::string& type);
+    /// The registered type names, sorted
+    static std::vector<std::string> types();
+
+  }; // class ToolStageFactory
+
+  /// Default creator of a stage type
+  template<typename STAGE>
+  ToolStage* createToolStage() { return new STAGE(); }
+
+} // namespace CPTutorial
+
+/// Register a ToolStage class under a type name, in a source file
+#define CPT_REGISTER_TOOL_STAGE( CLASS, TYPE )                         \
+  namespace {                                                          \
+    const bool CLASS ## _registered =                                  \
+      ::CPTutorial::ToolStageFactory::add(                             \
+        TYPE, &::CPTutorial::createToolStage< CLASS >);                \
+  }
+
+#endif // CPTUTORIALEXAMPLE_TOOLSTAGE_H
@@ -0,0 +1,74 @@
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/AccessModeComparison.h"
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/EventLoop.h"
+#include "CPTutorialExample/ProcessMemory.h"
+#include "CPTutorialExample/ForkedProcess.h"
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  AccessModeResult::AccessModeResult()
+    : mode(xAOD::TEvent::kClassAccess),
+      nEvents(0),
+      wallTime(0),
+      rssBefore(0),
+      rssAfter(0),
+      peakRss(0)
+  {}
+
+  StatusCode compareAccessModes(const JobConfig& config,
+                                std::vector<AccessModeResult>* results)
+  {
+    const char* APP_NAME = "compareAccessModes";
+    static const xAOD::TEvent::EAuxMode modes[] = {
+      xAOD::TEvent::kBranchAccess,
+      xAOD::TEvent::kClassAccess,
+      xAOD::TEvent::kAthenaAccess
+    };
+    static const unsigned int nModes = sizeof(modes) / sizeof(modes[0]);
+
+    std::vector<AccessModeResult> summary;
+    for(unsigned int i = 0; i < nModes; ++i) {
+      JobConfig modeConfig = config;
+      modeConfig.accessMode = modes[i];
+      Info(APP_NAME, "Running in %s access mode",
+           JobConfig::accessModeName(modes[i]));
+
+      // Every mode runs in a process of its own, so that its memory use
+      // is not hidden by that of the modes before it
+      AccessModeResult result;
+      result.mode = modes[i];
+      const auto job = [&modeConfig, &result]() -> StatusCode {
+        result.rssBefore = residentMemory();
+        EventLoop loop(modeConfig);
+        if(!loop.run().isSuccess()) return StatusCode::FAILURE;
+        result.nEvents = loop.result().nProcessed;
+        result.wallTime = loop.wallTime();
+        result.rssAfter = residentMemory();
+        return StatusCode::SUCCESS;
+      };
+      CPT_RETURN_CHECK( APP_NAME, runForked(job, &result, sizeof(result),
+                                            &result.peakRss) );
+      summary.push_back(result);
+    }
+
+    // Print the comparison
+    Info(APP_NAME, "%-8s %10s %10s %12s %12s", "mode", "events",
+         "events/s", "RSS growth", "peak RSS");
+    for(std::size_t i = 0; i < summary.size(); ++i) {
+      const AccessModeResult& r = summary[i];
+      Info(APP_NAME, "%-8s %10lli %10.1f %9.1f MB %9.1f MB",
+           JobConfig::accessModeName(r.mode), r.nEvents,
+           r.wallTime > 0 ? r.nEvents / r.wallTime : 0.,
+           r.rssAfter - r.rssBefore, r.peakRss);
+    }
+
+    if(results) *results = summary;
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
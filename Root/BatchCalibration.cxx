@@ -0,0 +1,97 @@
+// System includes
+#include <cmath>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/BatchCalibration.h"
+
+namespace {
+
+  /// The EtaBinnedScale kernel
+  ///
+  /// Kept free of member accesses and with restrict-qualified arrays, so
+  /// that the compiler knows the output doesn't alias the inputs and can
+  /// vectorise the loop. The bin lookup becomes a gather. At -O2 GCC
+  /// only vectorises with -ftree-vectorize, which the package sets.
+  /// The bin is clamped while still a float, where a NaN or huge eta
+  /// goes to the last bin, as converting those to int is undefined.
+  void etaBinnedScale(std::size_t n, const float* __restrict__ pt,
+                      const float* __restrict__ eta,
+                      const float* __restrict__ scales, int lastBin,
+                      float invBinWidth, float* __restrict__ result)
+  {
+    const float maxBin = static_cast<float>(lastBin);
+    for(std::size_t i = 0; i < n; ++i) {
+      const float x = std::fabs(eta[i]) * invBinWidth;
+      const int bin = static_cast<int>(x < maxBin ? x : maxBin);
+      result[i] = pt[i] * scales[bin];
+    }
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  const std::size_t ObjectBatch::npos;
+
+  ObjectBatch::ObjectBatch(const std::vector<std::string>& variables)
+    : m_names(variables),
+      m_accessors(),
+      m_columns(variables.size()),
+      m_size(0)
+  {
+    m_accessors.reserve(variables.size());
+    for(std::size_t i = 0; i < variables.size(); ++i) {
+      m_accessors.push_back(SG::AuxElement::ConstAccessor<float>(variables[i]));
+    }
+  }
+
+  void ObjectBatch::clear()
+  {
+    for(std::size_t i = 0; i < m_columns.size(); ++i) m_columns[i].clear();
+    m_size = 0;
+  }
+
+  std::size_t ObjectBatch::index(const std::string& variable) const
+  {
+    for(std::size_t i = 0; i < m_names.size(); ++i) {
+      if(m_names[i] == variable) return i;
+    }
+    return npos;
+  }
+
+  EtaBinnedScale::EtaBinnedScale(float etaMax,
+                                 const std::vector<float>& scales,
+                                 const std::string& ptName,
+                                 const std::string& etaName)
+    : m_scales(scales.empty() ? std::vector<float>(1, 1.f) : scales),
+      m_invBinWidth(etaMax > 0 ? m_scales.size() / etaMax : 0.f),
+      m_ptName(ptName),
+      m_etaName(etaName),
+      m_ptColumn(ObjectBatch::npos),
+      m_etaColumn(ObjectBatch::npos)
+  {}
+
+  StatusCode EtaBinnedScale::initialize(const ObjectBatch& batch)
+  {
+    m_ptColumn = batch.index(m_ptName);
+    m_etaColumn = batch.index(m_etaName);
+    if(m_ptColumn == ObjectBatch::npos || m_etaColumn == ObjectBatch::npos) {
+      ::Error("EtaBinnedScale", "The batch doesn't hold \"%s\" and \"%s\"",
+              m_ptName.c_str(), m_etaName.c_str());
+      return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  void EtaBinnedScale::apply(const ObjectBatch& batch, float* result) const
+  {
+    etaBinnedScale(batch.size(), batch.column(m_ptColumn),
+                   batch.column(m_etaColumn), m_scales.data(),
+                   static_cast<int>(m_scales.size()) - 1, m_invBinWidth,
+                   result);
+  }
+
+} // namespace CPTutorial
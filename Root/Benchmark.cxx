@@ -0,0 +1,158 @@
+// System includes
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/Benchmark.h"
+#include "CPTutorialExample/ResultStream.h"
+
+namespace {
+
+  /// Binning of LatencyHistogram
+  const int BINS_PER_DECADE = 20;
+  const double MIN_LOG10 = -9.; // 1 ns
+  // 12 decades, up to 1000 s, plus the underflow and overflow bins
+  const int N_BINS = 12 * BINS_PER_DECADE + 2;
+
+  /// Bin of a duration
+  int findBin(double seconds)
+  {
+    if(seconds <= 0) return 0;
+    const int bin = 1 + static_cast<int>(
+      std::floor((std::log10(seconds) - MIN_LOG10) * BINS_PER_DECADE));
+    return std::max(0, std::min(N_BINS - 1, bin));
+  }
+
+  /// Geometric centre of a bin
+  double binCentre(int bin)
+  {
+    return std::pow(10., MIN_LOG10 + (bin - 0.5) / BINS_PER_DECADE);
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  LatencyHistogram::LatencyHistogram()
+    : m_bins(N_BINS, 0),
+      m_count(0),
+      m_sum(0),
+      m_max(0)
+  {}
+
+  void LatencyHistogram::fill(double seconds)
+  {
+    ++m_bins[findBin(seconds)];
+    ++m_count;
+    m_sum += seconds;
+    m_max = std::max(m_max, seconds);
+  }
+
+  LatencyHistogram& LatencyHistogram::operator+=(const LatencyHistogram& rhs)
+  {
+    for(int i = 0; i < N_BINS; ++i) m_bins[i] += rhs.m_bins[i];
+    m_count += rhs.m_count;
+    m_sum += rhs.m_sum;
+    m_max = std::max(m_max, rhs.m_max);
+    return *this;
+  }
+
+  void LatencyHistogram::write(ResultWriter& out) const
+  {
+    out.put(m_bins);
+    out.put(m_count);
+    out.put(m_sum);
+    out.put(m_max);
+  }
+
+  bool LatencyHistogram::read(ResultReader& in)
+  {
+    return in.get(m_bins) && m_bins.size() == N_BINS && in.get(m_count) &&
+      in.get(m_sum) && in.get(m_max);
+  }
+
+  double LatencyHistogram::quantile(double fraction) const
+  {
+    if(m_count == 0) return 0;
+    const double target = fraction * m_count;
+    unsigned long long seen = 0;
+    for(int i = 0; i < N_BINS; ++i) {
+      seen += m_bins[i];
+      if(seen >= target && m_bins[i] > 0) {
+        // Never report more than the largest sample
+        return std::min(m_max, binCentre(i));
+      }
+    }
+    return m_max;
+  }
+
+  const char* PhaseTimes::phaseName(Phase phase)
+  {
+    switch(phase) {
+    case GetEntry: return "getEntry";
+    case Retrieve: return "retrieve";
+    case Preselect: return "preselect";
+    case Tools: return "tools";
+    case Clear: return "clear";
+    case Block: return "block";
+    case Event: return "event";
+    default: return "unknown";
+    }
+  }
+
+  PhaseTimes& PhaseTimes::operator+=(const PhaseTimes& rhs)
+  {
+    for(int i = 0; i < NPhases; ++i) m_phases[i] += rhs.m_phases[i];
+    return *this;
+  }
+
+  void PhaseTimes::write(ResultWriter& out) const
+  {
+    for(int i = 0; i < NPhases; ++i) m_phases[i].write(out);
+  }
+
+  bool PhaseTimes::read(ResultReader& in)
+  {
+    for(int i = 0; i < NPhases; ++i) {
+      if(!m_phases[i].read(in)) return false;
+    }
+    return true;
+  }
+
+  void PhaseTimes::print(const char* location) const
+  {
+    ::Info(location, "%-10s %10s %10s %10s %10s %10s", "phase",
+           "mean [us]", "p50 [us]", "p99 [us]", "max [us]", "total [s]");
+    for(int i = 0; i < NPhases; ++i) {
+      const LatencyHistogram& h = m_phases[i];
+      ::Info(location, "%-10s %10.2f %10.2f %10.2f %10.2f %10.3f",
+             phaseName(Phase(i)), 1e6 * h.mean(), 1e6 * h.quantile(0.5),
+             1e6 * h.quantile(0.99), 1e6 * h.max(), h.total());
+    }
+  }
+
+  void PhaseTimes::writeJson(std::string& json,
+                             const std::string& indent) const
+  {
+    char buffer[512];
+    json += "{\n";
+    for(int i = 0; i < NPhases; ++i) {
+      const LatencyHistogram& h = m_phases[i];
+      std::snprintf(buffer, sizeof(buffer),
+                    "%s  \"%s\": {\"count\": %llu, \"mean_us\": %.3f, "
+                    "\"p50_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, "
+                    "\"total_s\": %.6f}%s\n",
+                    indent.c_str(), phaseName(Phase(i)), h.count(),
+                    1e6 * h.mean(), 1e6 * h.quantile(0.5),
+                    1e6 * h.quantile(0.99), 1e6 * h.max(), h.total(),
+                    i + 1 < NPhases ? "," : "");
+      json += buffer;
+    }
+    json += indent + "}";
+  }
+
+} // namespace CPTutorial
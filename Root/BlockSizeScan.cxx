@@ -0,0 +1,64 @@
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/BlockSizeScan.h"
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/EventLoop.h"
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  BlockSizeResult::BlockSizeResult()
+    : blockSize(1),
+      nEvents(0),
+      wallTime(0),
+      meanEventTime(0)
+  {}
+
+  StatusCode scanBlockSizes(const JobConfig& config,
+                            std::vector<BlockSizeResult>* results)
+  {
+    const char* APP_NAME = "scanBlockSizes";
+
+    std::vector<BlockSizeResult> summary;
+    for(std::size_t i = 0; i < config.blockSizeScan.size(); ++i) {
+      JobConfig blockConfig = config;
+      blockConfig.blockSize = config.blockSizeScan[i];
+      blockConfig.blockSizeScan.clear();
+      Info(APP_NAME, "Running with a block size of %u",
+           blockConfig.blockSize);
+
+      BlockSizeResult result;
+      result.blockSize = blockConfig.blockSize;
+      {
+        EventLoop loop(blockConfig);
+        CPT_RETURN_CHECK( APP_NAME, loop.run() );
+        result.nEvents = loop.result().nProcessed;
+        result.wallTime = loop.wallTime();
+        result.meanEventTime =
+          result.nEvents > 0 ? result.wallTime / result.nEvents : 0.;
+      }
+      summary.push_back(result);
+    }
+
+    // Print the comparison
+    std::size_t best = 0;
+    Info(APP_NAME, "%-10s %10s %10s %14s", "block size", "events",
+         "events/s", "time/event");
+    for(std::size_t i = 0; i < summary.size(); ++i) {
+      const BlockSizeResult& r = summary[i];
+      Info(APP_NAME, "%-10u %10lli %10.1f %11.2f us", r.blockSize, r.nEvents,
+           r.wallTime > 0 ? r.nEvents / r.wallTime : 0.,
+           1e6 * r.meanEventTime);
+      if(r.meanEventTime < summary[best].meanEventTime) best = i;
+    }
+    if(!summary.empty()) {
+      Info(APP_NAME, "Fastest block size: %u", summary[best].blockSize);
+    }
+
+    if(results) *results = summary;
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,173 @@
+// ROOT includes
+#include "TError.h"
+
+// EDM includes
+#include "xAODEventInfo/EventInfo.h"
+#include "xAODJet/JetContainer.h"
+
+// Local includes
+#include "CPTutorialExample/ToolStage.h"
+#include "CPTutorialExample/BatchCalibration.h"
+#include "CPTutorialExample/ContainerHandle.h"
+#include "CPTutorialExample/EventBlock.h"
+#include "CPTutorialExample/Check.h"
+
+namespace {
+
+  /// Decorates EventInfo with a float variable of it times a factor
+  ///
+  /// Stands in for a CP tool in the configuration, and is useful in its
+  /// own right, e.g. for the data scale factor of the pile-up profile:
+  ///
+  ///   { "type": "EventInfoScale", "name": "MuScale",
+  ///     "properties": { "input": "averageInteractionsPerCrossing",
+  ///                     "output": "scaledAverageMu",
+  ///                     "scale": 0.9174 } }
+  ///
+  class EventInfoScale : public CPTutorial::ToolStage {
+
+  public:
+    EventInfoScale() : m_scale(1), m_input(), m_output() {}
+
+    virtual StatusCode initialize(const CPTutorial::ToolConfig& config)
+    {
+      const char* APP_NAME = config.name.c_str();
+      double scale = 1;
+      std::string input = "averageInteractionsPerCrossing";
+      std::string output = config.name;
+      CPT_RETURN_CHECK( APP_NAME, config.getDouble("scale", scale) );
+      CPT_RETURN_CHECK( APP_NAME, config.getString("input", input) );
+      CPT_RETURN_CHECK( APP_NAME, config.getString("output", output) );
+      m_scale = scale;
+      m_input.reset(new SG::AuxElement::ConstAccessor<float>(input));
+      m_output.reset(new SG::AuxElement::Decorator<float>(output));
+      return StatusCode::SUCCESS;
+    }
+
+    virtual StatusCode execute(const CPTutorial::ToolContext& context)
+    {
+      const xAOD::EventInfo& info = context.eventInfo;
+      (*m_output)(info) = (*m_input)(info) * m_scale;
+      return StatusCode::SUCCESS;
+    }
+
+  private:
+    float m_scale;
+    std::unique_ptr<SG::AuxElement::ConstAccessor<float> > m_input;
+    std::unique_ptr<SG::AuxElement::Decorator<float> > m_output;
+
+  }; // class EventInfoScale
+
+  /// Scales the pt of jets by a response correction in bins of |eta|
+  ///
+  /// Runs the EtaBinnedScale kernel of BatchCalibration.h over all jets
+  /// at once, instead of once per jet:
+  ///
+  ///   { "type": "EtaBinnedScale", "name": "JetPtScale",
+  ///     "container": "AntiKt4EMTopoJets",
+  ///     "properties": { "etaMax": 2.5,
+  ///                     "scales": [ 1.02, 1.03, 1.05, 1.08, 1.12 ],
+  ///                     "output": "ptScaled" } }
+  ///
+  /// "pt" and "eta" name the input variables, and "output" the
+  /// decoration of the result, the stage name by default. With
+  /// --block-size above 1 the jets of the whole block are gathered, and
+  /// calibrated together at its end. The jets of the earlier entries
+  /// can't be decorated any more by then, so the results go into the
+  /// object column "output" of the EventBlock instead, for the nominal
+  /// set only.
+  ///
+  class EtaBinnedScaleStage : public CPTutorial::ToolStage {
+
+  public:
+    EtaBinnedScaleStage()
+      : m_input(), m_batch(), m_kernel(), m_outputName(), m_output(),
+        m_offsets(), m_result() {}
+
+    virtual StatusCode initialize(const CPTutorial::ToolConfig& config)
+    {
+      const char* APP_NAME = config.name.c_str();
+      double etaMax = 0;
+      std::vector<double> scales;
+      std::string pt = "pt";
+      std::string eta = "eta";
+      std::string output = config.name;
+      CPT_RETURN_CHECK( APP_NAME, config.getDouble("etaMax", etaMax) );
+      CPT_RETURN_CHECK( APP_NAME, config.getDoubles("scales", scales) );
+      CPT_RETURN_CHECK( APP_NAME, config.getString("pt", pt) );
+      CPT_RETURN_CHECK( APP_NAME, config.getString("eta", eta) );
+      CPT_RETURN_CHECK( APP_NAME, config.getString("output", output) );
+      if(!(etaMax > 0) || scales.empty()) {
+        ::Error(APP_NAME, "A positive \"etaMax\" and at least one value "
+                "of \"scales\" are needed");
+        return StatusCode::FAILURE;
+      }
+
+      std::vector<std::string> variables;
+      variables.push_back(pt);
+      variables.push_back(eta);
+      m_batch.reset(new CPTutorial::ObjectBatch(variables));
+      m_kernel.reset(new CPTutorial::EtaBinnedScale(
+        static_cast<float>(etaMax),
+        std::vector<float>(scales.begin(), scales.end()), pt, eta));
+      CPT_RETURN_CHECK( APP_NAME, m_kernel->initialize(*m_batch) );
+      m_input.reset(
+        new CPTutorial::ContainerHandle<xAOD::JetContainer>(
+          config.container));
+      m_outputName = output;
+      m_output.reset(new SG::AuxElement::Decorator<float>(output));
+      return StatusCode::SUCCESS;
+    }
+
+    virtual bool readsContainer() const { return true; }
+
+    virtual StatusCode execute(const CPTutorial::ToolContext& context)
+    {
+      const char* APP_NAME = "EtaBinnedScale";
+      const xAOD::JetContainer* jets = m_input->get(context.cursor);
+      CPT_RETURN_CHECK( APP_NAME, jets );
+
+      // In a block the jets are only collected until its end
+      if(context.block) {
+        if(context.sys == 0) m_offsets.push_back(m_batch->gather(*jets));
+        return StatusCode::SUCCESS;
+      }
+      m_batch->clear();
+      m_batch->gather(*jets);
+      m_result.resize(m_batch->size());
+      m_kernel->apply(*m_batch, m_result.data());
+      CPTutorial::scatter(*jets, 0, m_result.data(), *m_output);
+      return StatusCode::SUCCESS;
+    }
+
+    virtual StatusCode executeBlock(CPTutorial::EventBlock& block)
+    {
+      if(m_offsets.empty()) return StatusCode::SUCCESS;
+      CPTutorial::ObjectColumn& column = block.objectColumn(m_outputName);
+      column.offsets.assign(m_offsets.begin(), m_offsets.end());
+      column.offsets.push_back(m_batch->size());
+      column.values.resize(m_batch->size());
+      m_kernel->apply(*m_batch, column.values.data());
+      m_offsets.clear();
+      m_batch->clear();
+      return StatusCode::SUCCESS;
+    }
+
+  private:
+    std::unique_ptr<CPTutorial::ContainerHandle<xAOD::JetContainer> >
+      m_input;
+    std::unique_ptr<CPTutorial::ObjectBatch> m_batch;
+    std::unique_ptr<CPTutorial::EtaBinnedScale> m_kernel;
+    std::string m_outputName;
+    std::unique_ptr<SG::AuxElement::Decorator<float> > m_output;
+    /// Offsets of the events of the current block in m_batch
+    std::vector<std::size_t> m_offsets;
+    /// Results of the current event
+    std::vector<float> m_result;
+
+  }; // class EtaBinnedScaleStage
+
+} // private namespace
+
+CPT_REGISTER_TOOL_STAGE( EventInfoScale, "EventInfoScale" )
+CPT_REGISTER_TOOL_STAGE( EtaBinnedScaleStage, "EtaBinnedScale" )
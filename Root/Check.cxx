@@ -0,0 +1,16 @@
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  void reportCheckFailure(const char* context, const char* expression,
+                          const char* file, int line)
+  {
+    ::Error(context, "Failed to execute: \"%s\" (%s:%i)", expression, file,
+            line);
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,197 @@
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/ColumnarOutput.h"
+#include "CPTutorialExample/OutputConfig.h"
+#include "CPTutorialExample/Check.h"
+
+namespace {
+
+  /// Bytes per value of a scalar column type
+  std::size_t columnWidth(CPTutorial::ColumnType type)
+  {
+    switch(type) {
+    case CPTutorial::kFloatColumn: return sizeof(Float_t);
+    case CPTutorial::kDoubleColumn: return sizeof(Double_t);
+    case CPTutorial::kIntColumn: return sizeof(Int_t);
+    case CPTutorial::kUIntColumn: return sizeof(UInt_t);
+    case CPTutorial::kULong64Column: return sizeof(ULong64_t);
+    default: return 0;
+    }
+  }
+
+  /// ROOT leaf type code of a scalar column type
+  const char* leafCode(CPTutorial::ColumnType type)
+  {
+    switch(type) {
+    case CPTutorial::kFloatColumn: return "F";
+    case CPTutorial::kDoubleColumn: return "D";
+    case CPTutorial::kIntColumn: return "I";
+    case CPTutorial::kUIntColumn: return "i";
+    case CPTutorial::kULong64Column: return "l";
+    default: return 0;
+    }
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  const std::size_t ColumnSchema::npos;
+
+  std::size_t ColumnSchema::add(const std::string& name, ColumnType type)
+  {
+    const std::size_t existing = index(name);
+    if(existing != npos) {
+      if(m_types[existing] != type) {
+        ::Error("ColumnSchema::add", "Column %s declared with two types",
+                name.c_str());
+      }
+      return existing;
+    }
+    m_names.push_back(name);
+    m_types.push_back(type);
+    return m_names.size() - 1;
+  }
+
+  std::size_t ColumnSchema::index(const std::string& name) const
+  {
+    for(std::size_t i = 0; i < m_names.size(); ++i) {
+      if(m_names[i] == name) return i;
+    }
+    return npos;
+  }
+
+  ColumnBuffer::ColumnBuffer(const ColumnSchema& schema)
+    : m_columns(schema.size()),
+      m_rows(0)
+  {
+    for(std::size_t i = 0; i < schema.size(); ++i) {
+      Column& col = m_columns[i];
+      col.type = schema.type(i);
+      col.width = columnWidth(col.type);
+      col.bytes.resize(col.width, 0);
+    }
+  }
+
+  void ColumnBuffer::endRow()
+  {
+    ++m_rows;
+    for(std::size_t i = 0; i < m_columns.size(); ++i) {
+      Column& col = m_columns[i];
+      if(col.type == kFloatArrayColumn) {
+        col.ends.push_back(col.values.size());
+      } else {
+        // Open the next row, zero-initialised
+        col.bytes.resize((m_rows + 1) * col.width, 0);
+      }
+    }
+  }
+
+  void ColumnBuffer::clear()
+  {
+    m_rows = 0;
+    for(std::size_t i = 0; i < m_columns.size(); ++i) {
+      Column& col = m_columns[i];
+      col.bytes.assign(col.width, 0);
+      col.values.clear();
+      col.ends.clear();
+    }
+  }
+
+  bool ColumnBuffer::checkType(std::size_t column, ColumnType type) const
+  {
+    if(column < m_columns.size() && m_columns[column].type == type) {
+      return true;
+    }
+    ::Error("ColumnBuffer", "Column %u can't take a value of type %d",
+            static_cast<unsigned int>(column), static_cast<int>(type));
+    return false;
+  }
+
+  ColumnarOutput::ColumnarOutput(const ColumnSchema& schema)
+    : m_schema(schema),
+      m_file(),
+      m_tree(0),
+      m_scalars(schema.size(), 0),
+      m_arrays(schema.size(), 0),
+      m_mutex(),
+      m_rowsWritten(0)
+  {}
+
+  ColumnarOutput::~ColumnarOutput()
+  {
+    for(std::size_t i = 0; i < m_arrays.size(); ++i) delete m_arrays[i];
+  }
+
+  StatusCode ColumnarOutput::open(const std::string& fileName,
+                                  const OutputConfig& output,
+                                  const std::string& treeName)
+  {
+    const char* APP_NAME = "ColumnarOutput";
+    m_file.reset(TFile::Open(fileName.c_str(), "RECREATE"));
+    CPT_RETURN_CHECK( APP_NAME, m_file.get() && !m_file->IsZombie() );
+    configureOutputFile(*m_file, output);
+
+    m_tree = new TTree(treeName.c_str(), "Columnar export");
+    m_tree->SetDirectory(m_file.get());
+    for(std::size_t i = 0; i < m_schema.size(); ++i) {
+      const std::string& name = m_schema.name(i);
+      const ColumnType type = m_schema.type(i);
+      if(type == kFloatArrayColumn) {
+        m_arrays[i] = new std::vector<Float_t>();
+        m_tree->Branch(name.c_str(), &m_arrays[i]);
+      } else {
+        m_tree->Branch(name.c_str(), &m_scalars[i],
+                       (name + "/" + leafCode(type)).c_str());
+      }
+    }
+    configureOutputTree(*m_tree, output);
+    Info(APP_NAME, "Writing %u columns to %s",
+         static_cast<unsigned int>(m_schema.size()), fileName.c_str());
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode ColumnarOutput::write(ColumnBuffer& buffer)
+  {
+    const char* APP_NAME = "ColumnarOutput";
+    CPT_RETURN_CHECK( APP_NAME, m_tree );
+    if(buffer.rows() == 0) return StatusCode::SUCCESS;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t nColumns = buffer.m_columns.size();
+    for(std::size_t row = 0; row < buffer.rows(); ++row) {
+      for(std::size_t i = 0; i < nColumns; ++i) {
+        const ColumnBuffer::Column& col = buffer.m_columns[i];
+        if(col.type == kFloatArrayColumn) {
+          const UInt_t begin = (row > 0 ? col.ends[row - 1] : 0);
+          m_arrays[i]->assign(col.values.begin() + begin,
+                              col.values.begin() + col.ends[row]);
+        } else {
+          std::memcpy(&m_scalars[i], &col.bytes[row * col.width], col.width);
+        }
+      }
+      CPT_RETURN_CHECK( APP_NAME, m_tree->Fill() >= 0 );
+    }
+    m_rowsWritten += buffer.rows();
+    buffer.clear();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode ColumnarOutput::close()
+  {
+    const char* APP_NAME = "ColumnarOutput";
+    if(!m_file) return StatusCode::SUCCESS;
+    m_file->cd();
+    CPT_RETURN_CHECK( APP_NAME, m_tree->Write() > 0 );
+    m_file->Close();
+    m_file.reset();
+    m_tree = 0;
+    Info(APP_NAME, "Wrote %lli rows", m_rowsWritten);
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,142 @@
+// System includes
+#include <algorithm>
+
+// ROOT includes
+#include "TTree.h"
+
+// Local includes
+#include "CPTutorialExample/EntryScheduler.h"
+
+namespace {
+
+  /// Whether the tree was written with cluster information
+  ///
+  /// Trees without it report a single cluster spanning the whole tree.
+  bool hasClusterInfo(TTree& tree)
+  {
+    TTree::TClusterIterator itr = tree.GetClusterIterator(0);
+    itr();
+    return itr.GetNextEntry() < tree.GetEntries();
+  }
+
+  /// Number of entries in a group
+  Long64_t groupSize(const CPTutorial::EntryGroup& group)
+  {
+    Long64_t size = 0;
+    for(std::size_t i = 0; i < group.size(); ++i) size += group[i].size();
+    return size;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  std::vector<EntryGroup> clusterGroups(TTree* tree,
+                                        const std::vector<EntryRange>& ranges,
+                                        Long64_t fallbackSize)
+  {
+    std::vector<EntryGroup> result;
+    if(fallbackSize <= 0) fallbackSize = 1;
+    const bool clustered = tree && hasClusterInfo(*tree);
+
+    // The cluster the last piece went into
+    Long64_t clusterBegin = 0, clusterEnd = 0;
+    for(std::size_t i = 0; i < ranges.size(); ++i) {
+      Long64_t begin = ranges[i].begin;
+      const Long64_t end =
+        tree ? std::min(ranges[i].end, tree->GetEntries()) : ranges[i].end;
+      while(begin < end) {
+        if(begin < clusterBegin || begin >= clusterEnd) {
+          if(clustered) {
+            TTree::TClusterIterator itr = tree->GetClusterIterator(begin);
+            clusterBegin = itr();
+            clusterEnd = itr.GetNextEntry();
+            if(clusterEnd <= begin) clusterEnd = end;
+          }
+          else {
+            clusterBegin = begin - begin % fallbackSize;
+            clusterEnd = clusterBegin + fallbackSize;
+          }
+          result.push_back(EntryGroup());
+        }
+        const Long64_t next = std::min(end, clusterEnd);
+        result.back().push_back(EntryRange(begin, next));
+        begin = next;
+      }
+    }
+    return result;
+  }
+
+  EntryScheduler::EntryScheduler(const std::vector<EntryGroup>& groups,
+                                 unsigned int nWorkers)
+    : m_queues()
+  {
+    if(nWorkers == 0) nWorkers = 1;
+    for(unsigned int i = 0; i < nWorkers; ++i) {
+      m_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    // Deal out contiguous blocks of roughly equal entry counts
+    Long64_t total = 0;
+    for(std::size_t i = 0; i < groups.size(); ++i) {
+      total += groupSize(groups[i]);
+    }
+    Long64_t assigned = 0;
+    for(std::size_t i = 0; i < groups.size(); ++i) {
+      const unsigned int worker = std::min<Long64_t>(
+        nWorkers - 1, total > 0 ? (assigned * nWorkers) / total : 0);
+      const Long64_t size = groupSize(groups[i]);
+      Queue& queue = *m_queues[worker];
+      queue.groups.push_back(groups[i]);
+      queue.remaining += size;
+      assigned += size;
+    }
+  }
+
+  bool EntryScheduler::next(unsigned int worker, EntryGroup& group,
+                            bool& stolen)
+  {
+    stolen = false;
+    {
+      Queue& own = *m_queues[worker];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if(!own.groups.empty()) {
+        group.swap(own.groups.front());
+        own.groups.pop_front();
+        own.remaining -= groupSize(group);
+        return true;
+      }
+    }
+    stolen = steal(worker, group);
+    return stolen;
+  }
+
+  bool EntryScheduler::steal(unsigned int thief, EntryGroup& group)
+  {
+    while(true) {
+      // Pick the victim with the most work left. Its queue may run dry
+      // before we get to lock it again, in which case we look again.
+      unsigned int victim = thief;
+      Long64_t most = 0;
+      for(unsigned int i = 0; i < m_queues.size(); ++i) {
+        if(i == thief) continue;
+        std::lock_guard<std::mutex> lock(m_queues[i]->mutex);
+        if(m_queues[i]->remaining > most) {
+          most = m_queues[i]->remaining;
+          victim = i;
+        }
+      }
+      if(victim == thief) return false;
+
+      // Take the group furthest away from where the victim is reading
+      Queue& queue = *m_queues[victim];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if(queue.groups.empty()) continue;
+      group.swap(queue.groups.back());
+      queue.groups.pop_back();
+      queue.remaining -= groupSize(group);
+      return true;
+    }
+  }
+
+} // namespace CPTutorial
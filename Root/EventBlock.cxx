@@ -0,0 +1,45 @@
+// EDM includes
+#include "xAODEventInfo/EventInfo.h"
+
+// Local includes
+#include "CPTutorialExample/EventBlock.h"
+
+namespace CPTutorial {
+
+  void EventBlock::clear()
+  {
+    nEntries = 0;
+    entry.clear();
+    runNumber.clear();
+    eventNumber.clear();
+    lumiBlock.clear();
+    averageMu.clear();
+    mcEventWeight.clear();
+    for(std::size_t i = 0; i < objects.size(); ++i) {
+      objects[i].offsets.clear();
+      objects[i].values.clear();
+    }
+  }
+
+  void EventBlock::push(Long64_t entryIndex, const xAOD::EventInfo& info)
+  {
+    entry.push_back(entryIndex);
+    runNumber.push_back(info.runNumber());
+    eventNumber.push_back(info.eventNumber());
+    lumiBlock.push_back(info.lumiBlock());
+    averageMu.push_back(info.averageInteractionsPerCrossing());
+    mcEventWeight.push_back(info.eventType(xAOD::EventInfo::IS_SIMULATION) ?
+                            info.mcEventWeight() : 1.f);
+  }
+
+  ObjectColumn& EventBlock::objectColumn(const std::string& name)
+  {
+    for(std::size_t i = 0; i < objects.size(); ++i) {
+      if(objects[i].name == name) return objects[i];
+    }
+    objects.push_back(ObjectColumn());
+    objects.back().name = name;
+    return objects.back();
+  }
+
+} // namespace CPTutorial
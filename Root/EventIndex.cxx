@@ -0,0 +1,218 @@
+// System includes
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/EventIndex.h"
+
+namespace {
+
+  /// Identifies index files, and their format version
+  const char MAGIC[8] = { 'C', 'P', 'T', 'I', 'D', 'X', '0', '1' };
+  /// Size of the header: magic, hash, tree entries, selected entries
+  const std::size_t HEADER_SIZE = sizeof(MAGIC) + 3 * 8;
+
+  const ULong64_t FNV_OFFSET = 14695981039346656037ull;
+  const ULong64_t FNV_PRIME = 1099511628211ull;
+
+  /// Continue an FNV-1a hash over some bytes
+  ULong64_t fnv1a(ULong64_t hash, const unsigned char* data, std::size_t n)
+  {
+    for(std::size_t i = 0; i < n; ++i) {
+      hash ^= data[i];
+      hash *= FNV_PRIME;
+    }
+    return hash;
+  }
+
+  /// Append a 64-bit number, little-endian
+  void putFixed(std::string& out, ULong64_t value)
+  {
+    for(int i = 0; i < 8; ++i) out += char((value >> (8 * i)) & 0xff);
+  }
+
+  /// Read a 64-bit little-endian number
+  ULong64_t getFixed(const unsigned char* in)
+  {
+    ULong64_t value = 0;
+    for(int i = 0; i < 8; ++i) value |= ULong64_t(in[i]) << (8 * i);
+    return value;
+  }
+
+  /// Append a number as a varint, 7 bits per byte
+  void putVarint(std::string& out, ULong64_t value)
+  {
+    while(value >= 0x80) {
+      out += char((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    out += char(value);
+  }
+
+  /// Read a varint, false if it runs past the end
+  bool getVarint(const unsigned char*& in, const unsigned char* end,
+                 ULong64_t& value)
+  {
+    value = 0;
+    for(int shift = 0; in != end && shift < 64; shift += 7) {
+      const unsigned char byte = *in++;
+      value |= ULong64_t(byte & 0x7f) << shift;
+      if(!(byte & 0x80)) return true;
+    }
+    return false;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  ULong64_t fnv1aHash(const std::string& text)
+  {
+    return fnv1a(FNV_OFFSET,
+                 reinterpret_cast<const unsigned char*>(text.data()),
+                 text.size());
+  }
+
+  EventIndex::EventIndex()
+    : m_treeEntries(0),
+      m_entries()
+  {}
+
+  std::string EventIndex::fileName(const std::string& directory,
+                                   const std::string& fileUUID,
+                                   ULong64_t selectionHash)
+  {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  static_cast<unsigned long long>(selectionHash));
+    std::string result = directory;
+    if(!result.empty() && result[result.size() - 1] != '/') result += '/';
+    return result + fileUUID + "_" + hash + ".idx";
+  }
+
+  bool EventIndex::read(const std::string& fileName, ULong64_t selectionHash,
+                        Long64_t treeEntries)
+  {
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    if(!in) return false;
+    const std::string data((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+    const unsigned char* begin =
+      reinterpret_cast<const unsigned char*>(data.data());
+
+    // Check the header and the checksum
+    if(data.size() < HEADER_SIZE + 8 ||
+       !std::equal(MAGIC, MAGIC + sizeof(MAGIC), data.begin()) ||
+       fnv1a(FNV_OFFSET, begin, data.size() - 8) !=
+       getFixed(begin + data.size() - 8)) {
+      ::Warning("EventIndex::read", "Ignoring corrupt index file %s",
+                fileName.c_str());
+      return false;
+    }
+    if(getFixed(begin + sizeof(MAGIC)) != selectionHash ||
+       Long64_t(getFixed(begin + sizeof(MAGIC) + 8)) != treeEntries) {
+      ::Warning("EventIndex::read", "Index file %s doesn't match its input",
+                fileName.c_str());
+      return false;
+    }
+
+    // Decode the entries
+    const ULong64_t count = getFixed(begin + sizeof(MAGIC) + 16);
+    const unsigned char* pos = begin + HEADER_SIZE;
+    const unsigned char* end = begin + data.size() - 8;
+    std::vector<Long64_t> entries;
+    entries.reserve(std::min<ULong64_t>(count, data.size()));
+    ULong64_t entry = 0;
+    for(ULong64_t i = 0; i < count; ++i) {
+      ULong64_t delta = 0;
+      if(!getVarint(pos, end, delta)) {
+        ::Warning("EventIndex::read", "Ignoring truncated index file %s",
+                  fileName.c_str());
+        return false;
+      }
+      // The entries have to increase, and stay within the tree
+      if((i > 0 && delta == 0) ||
+         delta >= ULong64_t(treeEntries) - entry) {
+        ::Warning("EventIndex::read", "Ignoring corrupt index file %s",
+                  fileName.c_str());
+        return false;
+      }
+      entry += delta;
+      entries.push_back(entry);
+    }
+    if(pos != end) {
+      ::Warning("EventIndex::read", "Ignoring corrupt index file %s",
+                fileName.c_str());
+      return false;
+    }
+    m_treeEntries = treeEntries;
+    m_entries.swap(entries);
+    return true;
+  }
+
+  StatusCode EventIndex::write(const std::string& fileName,
+                               ULong64_t selectionHash) const
+  {
+    std::string data(MAGIC, sizeof(MAGIC));
+    putFixed(data, selectionHash);
+    putFixed(data, m_treeEntries);
+    putFixed(data, m_entries.size());
+    ULong64_t previous = 0;
+    for(std::size_t i = 0; i < m_entries.size(); ++i) {
+      putVarint(data, m_entries[i] - previous);
+      previous = m_entries[i];
+    }
+    putFixed(data, fnv1a(FNV_OFFSET,
+                         reinterpret_cast<const unsigned char*>(data.data()),
+                         data.size()));
+
+    // Write to a temporary file first, so that concurrent jobs never see
+    // a partial index
+    const std::string tmpName = fileName + ".tmp" + std::to_string(getpid());
+    {
+      std::ofstream out(tmpName.c_str(), std::ios::binary);
+      out.write(data.data(), data.size());
+      if(!out) {
+        ::Error("EventIndex::write", "Can't write index file %s",
+                tmpName.c_str());
+        return StatusCode::FAILURE;
+      }
+    }
+    if(std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+      ::Error("EventIndex::write", "Can't rename %s to %s", tmpName.c_str(),
+              fileName.c_str());
+      std::remove(tmpName.c_str());
+      return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  void EventIndex::set(Long64_t treeEntries,
+                       const std::vector<Long64_t>& entries)
+  {
+    m_treeEntries = treeEntries;
+    m_entries = entries;
+    std::sort(m_entries.begin(), m_entries.end());
+    m_entries.erase(std::unique(m_entries.begin(), m_entries.end()),
+                    m_entries.end());
+  }
+
+  std::vector<EntryRange> EventIndex::ranges(const EntryRange& range) const
+  {
+    std::vector<EntryRange> result;
+    std::vector<Long64_t>::const_iterator itr =
+      std::lower_bound(m_entries.begin(), m_entries.end(), range.begin);
+    for(; itr != m_entries.end() && *itr < range.end; ++itr) {
+      if(!result.empty() && result.back().end == *itr) ++result.back().end;
+      else result.push_back(EntryRange(*itr, *itr + 1));
+    }
+    return result;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,765 @@
+// System includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ROOT includes
+#include "TROOT.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TError.h"
+#include "TTree.h"
+#include "TSystem.h"
+
+// Local includes
+#include "CPTutorialExample/EventLoop.h"
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/EntryScheduler.h"
+#include "CPTutorialExample/FilePrefetcher.h"
+#include "CPTutorialExample/LogSink.h"
+#include "CPTutorialExample/ProgressReporter.h"
+#include "CPTutorialExample/ColumnarOutput.h"
+#include "CPTutorialExample/Histograms.h"
+#include "CPTutorialExample/SkimWriter.h"
+#include "CPTutorialExample/MemoryAccounting.h"
+#include "CPTutorialExample/ProcessMemory.h"
+#include "CPTutorialExample/StartupTimer.h"
+#include "CPTutorialExample/EventIndex.h"
+#include "CPTutorialExample/EventPreselection.h"
+#include "CPTutorialExample/ResultStream.h"
+#include "CPTutorialExample/Check.h"
+
+namespace {
+
+  /// Number of entries in the event tree of a file
+  Long64_t treeEntries(TFile& file)
+  {
+    const TTree* tree = dynamic_cast<TTree*>(file.Get("CollectionTree"));
+    return tree ? tree->GetEntries() : 0;
+  }
+
+  /// Start ROOT's implicit multi-threading pool, unless nThreads is 0
+  void enableThreadPool(unsigned int nThreads)
+  {
+    if(nThreads == 0) return;
+    ROOT::EnableImplicitMT(nThreads);
+    ::Info("EventLoop", "Using ROOT's thread pool of %u threads", nThreads);
+  }
+
+  /// Write a whole buffer to a file descriptor
+  bool writeAll(int fd, const char* data, std::size_t size)
+  {
+    while(size > 0) {
+      const ssize_t n = ::write(fd, data, size);
+      if(n <= 0) return false;
+      data += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  /// Read a whole buffer from a file descriptor
+  bool readAll(int fd, char* data, std::size_t size)
+  {
+    while(size > 0) {
+      const ssize_t n = ::read(fd, data, size);
+      if(n <= 0) return false;
+      data += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  /// Name of the part of an output file written by one process
+  std::string partName(const std::string& fileName, int process)
+  {
+    const std::string tag = ".part" + std::to_string(process);
+    const std::string::size_type dot = fileName.rfind('.');
+    const std::string::size_type slash = fileName.rfind('/');
+    if(dot == std::string::npos ||
+       (slash != std::string::npos && dot < slash)) {
+      return fileName + tag;
+    }
+    return fileName.substr(0, dot) + tag + fileName.substr(dot);
+  }
+
+  /// Merge the parts of an output file into it, and remove them
+  StatusCode mergeParts(const std::string& fileName, unsigned int nParts,
+                        const CPTutorial::OutputConfig& output)
+  {
+    const char* APP_NAME = "EventLoop";
+    TFileMerger merger(kFALSE);
+    merger.SetFastMethod(kTRUE);
+    merger.SetPrintLevel(0);
+    const bool opened = output.compression >= 0 ?
+      merger.OutputFile(fileName.c_str(), "RECREATE", output.compression) :
+      merger.OutputFile(fileName.c_str(), "RECREATE");
+    CPT_RETURN_CHECK( APP_NAME, opened );
+    for(unsigned int i = 0; i < nParts; ++i) {
+      CPT_RETURN_CHECK( APP_NAME,
+                        merger.AddFile(partName(fileName, i).c_str()) );
+    }
+    CPT_RETURN_CHECK( APP_NAME, merger.Merge() );
+    for(unsigned int i = 0; i < nParts; ++i) {
+      gSystem->Unlink(partName(fileName, i).c_str());
+    }
+    Info(APP_NAME, "Merged the output of %u processes into %s", nParts,
+         fileName.c_str());
+    return StatusCode::SUCCESS;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  EventLoop::EventLoop(const JobConfig& config)
+    : m_config(config),
+      m_workers(),
+      m_tailTime(),
+      m_result(),
+      m_workerResults(),
+      m_wallTime(0),
+      m_fileWaitTime(0),
+      m_logSink(),
+      m_progress(),
+      m_startup(0),
+      m_memoryMonitor(),
+      m_columnarOutput(),
+      m_histogramBook(),
+      m_skimWriter(),
+      m_process(-1),
+      m_resultPipe(-1),
+      m_children()
+  {}
+
+  EventLoop::~EventLoop()
+  {}
+
+  StatusCode EventLoop::run()
+  {
+    const StatusCode result = runLoop();
+    if(m_process >= 0) finishProcess(result);
+    return result;
+  }
+
+  StatusCode EventLoop::runLoop()
+  {
+    const char* APP_NAME = "EventLoop";
+    const Clock::time_point start = Clock::now();
+
+    // ROOT has to be told about threads before any file is opened
+    if(m_config.nThreads > 1 || m_config.pipelineThreads > 0) {
+      ROOT::EnableThreadSafety();
+    }
+
+    // The length of the cache learning phase is global as well
+    setCacheLearnEntries(m_config.readCache);
+
+    // Allocations are only counted when the memory is reported, so that
+    // the tool setup is counted too
+    if(m_config.memoryReport) enableAllocationCounting();
+
+    // The first worker lives on the main thread
+    m_workers.clear();
+    m_tailTime.clear();
+    m_workers.push_back(std::unique_ptr<EventWorker>(
+      new EventWorker(0, m_config)));
+    m_tailTime.push_back(0);
+    EventWorker& primary = *m_workers[0];
+    CPT_RETURN_CHECK( APP_NAME, primary.initialize() );
+    if(m_startup) {
+      m_startup->mark(m_config.lazyInit ? "Event setup" :
+                      "Event and CP tool setup");
+      primary.setStartupTimer(m_startup);
+    }
+
+    // The entries to process, counted across all input files. With
+    // --processes the setup above is shared, copy-on-write, by processes
+    // forked here, each processing a slice of the entries.
+    Long64_t first = m_config.firstEntry();
+    Long64_t last = m_config.lastEntry();
+    if(m_config.nProcesses > 1) {
+      CPT_RETURN_CHECK( APP_NAME, forkProcesses(first, last) );
+      if(m_process < 0) return mergeProcesses(start);
+    }
+
+    // Progress messages go through a buffered sink, off the event loop
+    m_logSink.reset(new AsyncLogSink());
+    m_progress.reset(new ProgressReporter(*m_logSink, m_config.progressEvery,
+                                          m_config.progressInterval));
+    if(last >= 0) m_progress->setExpected(last - first);
+    primary.setProgress(m_progress.get());
+    if(m_config.memoryReport) {
+      if(!allocationCountingActive()) {
+        Warning(APP_NAME, "Another operator new is in use, the allocations "
+                "can't be counted");
+      }
+      m_memoryMonitor.reset(new MemoryMonitor());
+      m_progress->setMemoryMonitor(m_memoryMonitor.get());
+      primary.setMemoryMonitor(m_memoryMonitor.get());
+    }
+
+    // ROOT's thread pool decompresses the input with --pipeline, and
+    // compresses the outputs with --compression-threads. It can only be
+    // sized once, so it gets the larger of the two.
+    const bool hasOutputs =
+      (!m_config.columnarOutput.empty() || !m_config.skimOutput.empty() ||
+       !m_config.histogramOutput.empty());
+    const unsigned int compressionThreads =
+      hasOutputs ? m_config.output.compressionThreads : 0;
+    enableThreadPool(std::max(m_config.pipelineThreads, compressionThreads));
+    if(compressionThreads > 0) {
+      Info(APP_NAME, "Compressing the output baskets on ROOT's thread pool");
+    }
+
+    // TEvent can only be driven by one thread, but the decompression of
+    // the next cluster of the input can be done ahead of it by others
+    if(m_config.pipelineThreads > 0) {
+      enableParallelUnzip();
+      Info(APP_NAME, "Decompressing the input baskets on ROOT's thread "
+           "pool");
+    }
+
+    // Open the columnar output
+    if(!m_config.columnarOutput.empty()) {
+      ColumnSchema schema;
+      EventWorker::declareColumns(schema);
+      m_columnarOutput.reset(new ColumnarOutput(schema));
+      CPT_RETURN_CHECK( APP_NAME,
+                        m_columnarOutput->open(
+                          outputName(m_config.columnarOutput),
+                                               m_config.output) );
+      primary.setColumnarOutput(m_columnarOutput.get());
+    }
+
+    // Every worker fills its own copy of the histograms
+    if(!m_config.histogramOutput.empty()) {
+      m_histogramBook.reset(new HistogramBook());
+      EventWorker::declareHistograms(*m_histogramBook);
+      primary.setHistograms(m_histogramBook.get());
+    }
+
+    // The skim is written from the entries the workers accepted
+    if(!m_config.skimOutput.empty()) {
+      m_skimWriter.reset(new SkimWriter());
+      CPT_RETURN_CHECK( APP_NAME, m_skimWriter->open(
+                          outputName(m_config.skimOutput), m_config.output) );
+    }
+
+    // Cached event indices only make sense with a preselection
+    EventPreselection preselection(m_config);
+    const bool useIndex =
+      (!m_config.indexCache.empty() && preselection.active());
+    if(useIndex) CPT_RETURN_CHECK( APP_NAME, preselection.initialize() );
+    const ULong64_t selectionHash =
+      useIndex ? fnv1aHash(preselection.description()) : 0;
+    if(useIndex) gSystem->mkdir(m_config.indexCache.c_str(), kTRUE);
+
+    // Loop over the input files, opening the next one while the current
+    // one is being processed
+    const std::vector<std::string>& files = m_config.inputFiles;
+    FilePrefetcher prefetcher(m_config.prefetch);
+    prefetcher.prefetch(files[0]);
+    Long64_t offset = 0;
+    for(std::size_t i = 0; i < files.size(); ++i) {
+      std::unique_ptr<TFile> file = prefetcher.take();
+      CPT_RETURN_CHECK( APP_NAME, file.get() );
+      if(m_startup && i == 0) m_startup->mark("Opening the first input file");
+
+      // Files before the requested range only need their entry count
+      const Long64_t fileEntries = treeEntries(*file);
+      const Long64_t fileStart = offset;
+      const EntryRange range(std::max(0ll, first - offset),
+                             last < 0 ? fileEntries :
+                             std::min(fileEntries, last - offset));
+      offset += fileEntries;
+      const bool done = (last >= 0 && offset >= last);
+      if(last < 0 && files.size() == 1) {
+        m_progress->setExpected(range.size());
+      }
+      if(i + 1 < files.size() && !done) prefetcher.prefetch(files[i + 1]);
+      if(range.size() > 0) {
+        Info(APP_NAME, "Processing file %u/%u: %s",
+             static_cast<unsigned int>(i + 1),
+             static_cast<unsigned int>(files.size()), files[i].c_str());
+        const std::string indexFile = useIndex ?
+          EventIndex::fileName(m_config.indexCache,
+                               file->GetUUID().AsString(), selectionHash) :
+          std::string();
+        CPT_RETURN_CHECK( APP_NAME, primary.setInput(std::move(file)) );
+        Info(APP_NAME, "Number of events in the file: %lli, processing "
+             "entries [%lli, %lli)", fileEntries, range.begin, range.end);
+
+        // With an index from an earlier run, only its entries are read
+        std::vector<EntryRange> ranges(1, range);
+        EventIndex index;
+        const bool indexed =
+          useIndex && index.read(indexFile, selectionHash, fileEntries);
+        if(indexed) {
+          ranges = index.ranges(range);
+          Info(APP_NAME, "Using the event index %s: %lli of %lli entries "
+               "selected", indexFile.c_str(),
+               static_cast<Long64_t>(index.entries().size()), fileEntries);
+        }
+
+        if(m_config.nThreads > 1) {
+          CPT_RETURN_CHECK( APP_NAME, runThreaded(files[i], ranges) );
+        }
+        else {
+          for(std::size_t r = 0; r < ranges.size(); ++r) {
+            CPT_RETURN_CHECK( APP_NAME, primary.processRange(
+                                ranges[r].begin, ranges[r].end) );
+          }
+        }
+
+        // Copy the accepted entries to the skim, from a handle of the
+        // file of its own. A file split between processes has its
+        // metadata copied only by the one processing its first entry, or
+        // the merged skim would count it more than once.
+        std::vector<Long64_t> accepted;
+        for(std::size_t w = 0; w < m_workers.size(); ++w) {
+          m_workers[w]->takeAcceptedEntries(accepted);
+        }
+        if(m_skimWriter) {
+          const bool copyMetaData =
+            (range.begin == std::max(0ll, m_config.firstEntry() - fileStart));
+          CPT_RETURN_CHECK( APP_NAME,
+                            m_skimWriter->addFile(files[i], accepted,
+                                                  copyMetaData) );
+        }
+
+        // Index the file if all of it was scanned
+        if(useIndex && !indexed && range.begin == 0 &&
+           range.end == fileEntries) {
+          index.set(fileEntries, accepted);
+          if(index.write(indexFile, selectionHash).isSuccess()) {
+            Info(APP_NAME, "Wrote the event index %s", indexFile.c_str());
+          }
+        }
+      }
+      if(done) break;
+    }
+    m_fileWaitTime = prefetcher.waitTime();
+    for(std::size_t i = 0; i < m_workers.size(); ++i) {
+      CPT_RETURN_CHECK( APP_NAME, m_workers[i]->finalize() );
+      m_workers[i]->setProgress(0);
+      m_workers[i]->setMemoryMonitor(0);
+      m_workers[i]->setStartupTimer(0);
+      m_workers[i]->setColumnarOutput(0);
+    }
+    if(m_columnarOutput) {
+      CPT_RETURN_CHECK( APP_NAME, m_columnarOutput->close() );
+      m_columnarOutput.reset();
+    }
+    if(m_skimWriter) {
+      CPT_RETURN_CHECK( APP_NAME, m_skimWriter->close() );
+      m_skimWriter.reset();
+    }
+    if(m_histogramBook) {
+      std::vector<const HistogramAccumulator*> histograms;
+      for(std::size_t i = 0; i < m_workers.size(); ++i) {
+        histograms.push_back(m_workers[i]->histograms());
+      }
+      CPT_RETURN_CHECK( APP_NAME, m_histogramBook->write(
+                          outputName(m_config.histogramOutput), histograms,
+                          m_config.output) );
+      for(std::size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->setHistograms(0);
+      }
+      m_histogramBook.reset();
+    }
+
+    // Write out the pending messages before the summary
+    m_progress.reset();
+    m_logSink.reset();
+    m_memoryMonitor.reset();
+
+    // Collect and merge the worker results. Time between a worker running
+    // out of work and the last worker finishing counts as idle time.
+    m_result = WorkerResult();
+    m_workerResults.clear();
+    for(std::size_t i = 0; i < m_workers.size(); ++i) {
+      WorkerResult r = m_workers[i]->result();
+      r.loopTime += m_tailTime[i];
+      r.idleTime += m_tailTime[i];
+      m_workerResults.push_back(r);
+      m_result += r;
+    }
+    m_wallTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // A forked process sends its results to the parent, which reports
+    // for all of them
+    if(m_process >= 0) return StatusCode::SUCCESS;
+    return report();
+  }
+
+  StatusCode EventLoop::report() const
+  {
+    const char* APP_NAME = "EventLoop";
+    printSummary();
+    if(m_startup && m_config.startupReport) m_startup->print(APP_NAME);
+    if(m_config.benchmark) {
+      CPT_RETURN_CHECK( APP_NAME, writeBenchmark(m_config.benchmarkOutput) );
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventLoop::forkProcesses(Long64_t& first, Long64_t& last)
+  {
+    const char* APP_NAME = "EventLoop";
+
+    // Without an explicit end the entries need to be counted up front
+    if(last < 0) {
+      last = 0;
+      for(std::size_t i = 0; i < m_config.inputFiles.size(); ++i) {
+        std::unique_ptr<TFile> file(
+          TFile::Open(m_config.inputFiles[i].c_str(), "READ"));
+        CPT_RETURN_CHECK( APP_NAME, file.get() && !file->IsZombie() );
+        last += treeEntries(*file);
+      }
+      last = std::max(first, last);
+    }
+
+    // Never fork more processes than there are entries
+    const Long64_t nEntries = last - first;
+    const unsigned int nProcesses = static_cast<unsigned int>(
+      std::max(1ll, std::min<Long64_t>(m_config.nProcesses, nEntries)));
+    Info(APP_NAME, "Processing %lli entries in %u processes", nEntries,
+         nProcesses);
+
+    // Whatever is buffered would otherwise be written by every process
+    std::fflush(stdout);
+    std::fflush(stderr);
+    for(unsigned int i = 0; i < nProcesses; ++i) {
+      const Long64_t begin = first + nEntries * i / nProcesses;
+      const Long64_t end = first + nEntries * (i + 1) / nProcesses;
+      int fds[2];
+      if(::pipe(fds) != 0) {
+        Error(APP_NAME, "Can't create the pipe of process %u", i);
+        abortProcesses();
+        return StatusCode::FAILURE;
+      }
+      const pid_t pid = ::fork();
+      if(pid < 0) {
+        Error(APP_NAME, "Can't fork process %u", i);
+        ::close(fds[0]);
+        ::close(fds[1]);
+        abortProcesses();
+        return StatusCode::FAILURE;
+      }
+      if(pid == 0) {
+        // The child only keeps the write end of its own pipe
+        for(std::size_t j = 0; j < m_children.size(); ++j) {
+          ::close(m_children[j].resultPipe);
+        }
+        m_children.clear();
+        ::close(fds[0]);
+        m_process = i;
+        m_resultPipe = fds[1];
+        first = begin;
+        last = end;
+        Info(APP_NAME, "Process %u: entries [%lli, %lli)", i, first, last);
+        return StatusCode::SUCCESS;
+      }
+      ::close(fds[1]);
+      const ChildProcess child = { pid, fds[0] };
+      m_children.push_back(child);
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventLoop::mergeProcesses(const Clock::time_point& start)
+  {
+    const char* APP_NAME = "EventLoop";
+
+    // Every process sends its results before exiting. They are merged
+    // as those of the workers of a threaded job.
+    bool success = true;
+    m_result = WorkerResult();
+    m_workerResults.clear();
+    m_fileWaitTime = 0;
+    for(std::size_t i = 0; i < m_children.size(); ++i) {
+      const ChildProcess& child = m_children[i];
+      unsigned long long size = 0;
+      std::string data;
+      bool reported =
+        readAll(child.resultPipe, reinterpret_cast<char*>(&size),
+                sizeof(size));
+      if(reported) {
+        data.resize(size);
+        reported = (size == 0 || readAll(child.resultPipe, &data[0], size));
+      }
+      ::close(child.resultPipe);
+      int status = 0;
+      const bool exited = (::waitpid(child.pid, &status, 0) == child.pid &&
+                           WIFEXITED(status) && WEXITSTATUS(status) == 0);
+      WorkerResult r;
+      double fileWaitTime = 0;
+      ResultReader in(data);
+      if(!reported || !exited || !r.read(in) || !in.get(fileWaitTime) ||
+         !in.atEnd()) {
+        Error(APP_NAME, "Process %u failed", static_cast<unsigned int>(i));
+        success = false;
+        continue;
+      }
+      m_workerResults.push_back(r);
+      m_result += r;
+      m_fileWaitTime = std::max(m_fileWaitTime, fileWaitTime);
+    }
+    const unsigned int nProcesses = m_children.size();
+    m_children.clear();
+    if(!success) {
+      removeParts(nProcesses);
+      return StatusCode::FAILURE;
+    }
+
+    // The parts are merged in the order of their slices, which keeps the
+    // events in the order of the input
+    const std::string outputs[] = {
+      m_config.columnarOutput, m_config.skimOutput, m_config.histogramOutput
+    };
+    for(std::size_t i = 0; i < sizeof(outputs) / sizeof(std::string); ++i) {
+      if(outputs[i].empty()) continue;
+      CPT_RETURN_CHECK( APP_NAME, mergeParts(outputs[i], nProcesses,
+                                             m_config.output) );
+    }
+
+    m_wallTime = std::chrono::duration<double>(Clock::now() - start).count();
+    Info(APP_NAME, "Merged the results of %u processes", nProcesses);
+    return report();
+  }
+
+  void EventLoop::abortProcesses()
+  {
+    // The processes forked so far would otherwise carry on with their
+    // slices, and leave their parts of the outputs behind
+    for(std::size_t i = 0; i < m_children.size(); ++i) {
+      ::kill(m_children[i].pid, SIGKILL);
+    }
+    for(std::size_t i = 0; i < m_children.size(); ++i) {
+      ::close(m_children[i].resultPipe);
+      int status = 0;
+      ::waitpid(m_children[i].pid, &status, 0);
+    }
+    removeParts(m_children.size());
+    m_children.clear();
+  }
+
+  void EventLoop::removeParts(unsigned int nParts) const
+  {
+    const std::string outputs[] = {
+      m_config.columnarOutput, m_config.skimOutput, m_config.histogramOutput
+    };
+    for(std::size_t i = 0; i < sizeof(outputs) / sizeof(std::string); ++i) {
+      if(outputs[i].empty()) continue;
+      for(unsigned int j = 0; j < nParts; ++j) {
+        gSystem->Unlink(partName(outputs[i], j).c_str());
+      }
+    }
+  }
+
+  void EventLoop::finishProcess(const StatusCode& result)
+  {
+    // Exit without running the parent's atexit handlers and static
+    // destructors; the outputs were closed by the loop already
+    bool ok = result.isSuccess();
+    if(ok) {
+      ResultWriter out;
+      m_result.write(out);
+      out.put(m_fileWaitTime);
+      const unsigned long long size = out.data().size();
+      ok = (writeAll(m_resultPipe, reinterpret_cast<const char*>(&size),
+                     sizeof(size)) &&
+            writeAll(m_resultPipe, out.data().data(), size));
+    }
+    ::close(m_resultPipe);
+    std::fflush(stdout);
+    std::fflush(stderr);
+    ::_exit(ok ? EXIT_SUCCESS : 1);
+  }
+
+  std::string EventLoop::outputName(const std::string& fileName) const
+  {
+    return m_process < 0 ? fileName : partName(fileName, m_process);
+  }
+
+  StatusCode EventLoop::runThreaded(const std::string& fileName,
+                                    const std::vector<EntryRange>& selected)
+  {
+    typedef std::chrono::steady_clock clock;
+    const char* APP_NAME = "EventLoop";
+    EventWorker& primary = *m_workers[0];
+
+    // Cut the work at the cluster boundaries of the input tree. The
+    // selected entries of one cluster, however sparse, are handed out
+    // together, so that no two workers decompress the same baskets.
+    const std::vector<EntryGroup> groups =
+      clusterGroups(primary.inputTree(), selected);
+    Long64_t nEntries = 0;
+    for(std::size_t i = 0; i < selected.size(); ++i) {
+      nEntries += selected[i].size();
+    }
+
+    // Never start more workers than there are entries
+    const unsigned int nWorkers = static_cast<unsigned int>(
+      std::max(1ll, std::min<Long64_t>(m_config.nThreads, nEntries)));
+    Info(APP_NAME, "Processing %lli entries in %u clusters with %u worker "
+         "threads", nEntries, static_cast<unsigned int>(groups.size()),
+         nWorkers);
+    EntryScheduler scheduler(groups, nWorkers);
+
+    // Secondary workers are kept for the whole job, but open their own
+    // handle of every file on their own thread, so that (possibly remote)
+    // file opening happens in parallel too.
+    while(m_workers.size() < nWorkers) {
+      m_workers.push_back(std::unique_ptr<EventWorker>(
+        new EventWorker(m_workers.size(), m_config)));
+      m_workers.back()->setProgress(m_progress.get());
+      m_workers.back()->setMemoryMonitor(m_memoryMonitor.get());
+      m_workers.back()->setStartupTimer(m_startup);
+      m_workers.back()->setColumnarOutput(m_columnarOutput.get());
+      m_workers.back()->setHistograms(m_histogramBook.get());
+      m_tailTime.push_back(0);
+    }
+    std::vector<char> ok(nWorkers, 0);
+    std::vector<clock::time_point> finished(nWorkers);
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers - 1);
+    for(unsigned int i = 1; i < nWorkers; ++i) {
+      EventWorker* worker = m_workers[i].get();
+      char* status = &ok[i];
+      clock::time_point* done = &finished[i];
+      threads.push_back(std::thread([=, &fileName, &scheduler]() {
+            *status = ((worker->isInitialized() ||
+                        worker->initialize().isSuccess()) &&
+                       worker->openFile(fileName).isSuccess() &&
+                       worker->process(scheduler).isSuccess());
+            *done = clock::now();
+          }));
+    }
+
+    // The primary worker takes part on the main thread
+    ok[0] = primary.process(scheduler).isSuccess();
+    finished[0] = clock::now();
+
+    for(std::size_t i = 0; i < threads.size(); ++i) threads[i].join();
+    const clock::time_point end = clock::now();
+
+    bool success = true;
+    for(unsigned int i = 0; i < nWorkers; ++i) {
+      m_tailTime[i] += std::chrono::duration<double>(end - finished[i]).count();
+      if(!ok[i]) {
+        Error(APP_NAME, "Worker %u failed", i);
+        success = false;
+      }
+    }
+    return success ? StatusCode::SUCCESS : StatusCode::FAILURE;
+  }
+
+  void EventLoop::printSummary() const
+  {
+    const char* APP_NAME = "EventLoop";
+    if(m_workerResults.size() > 1) {
+      for(std::size_t i = 0; i < m_workerResults.size(); ++i) {
+        const WorkerResult& r = m_workerResults[i];
+        Info(APP_NAME, "Worker %u: %lli events in %lli ranges (%lli stolen), "
+             "%.2f s busy, %.2f s idle",
+             static_cast<unsigned int>(i), r.nProcessed, r.nRanges,
+             r.nStolen, r.loopTime - r.idleTime, r.idleTime);
+      }
+    }
+    const ReadStats& io = m_result.readStats;
+    Info(APP_NAME, "Read %lli bytes in %lli read calls (%.1f kB/call), "
+         "%.1f%% of them through the TTreeCache",
+         io.bytesRead, io.readCalls,
+         io.readCalls > 0 ? io.bytesRead / 1024. / io.readCalls : 0.,
+         100. * io.cacheHitRatio());
+    if(m_config.recycleTransients) {
+      const RecyclingStats& rs = m_result.recycling;
+      Info(APP_NAME, "Transient objects: %llu created, %llu recycled, "
+           "arena of %.1f kB", rs.nCreated, rs.nReused,
+           rs.arenaCapacity / 1024.);
+    }
+    if(m_config.memoryReport) {
+      // With --processes, that of the largest process
+      const double peakRss = m_config.nProcesses > 1 ?
+        std::max(peakResidentMemory(), childrenPeakResidentMemory()) :
+        peakResidentMemory();
+      const double events = std::max(1ll, m_result.nProcessed);
+      Info(APP_NAME, "Peak RSS %.0f MB, %.1f kB allocated per event in %.1f "
+           "allocations", peakRss,
+           m_result.allocations.bytes / 1024. / events,
+           m_result.allocations.nAllocations / events);
+      m_result.memory.print(APP_NAME, m_result.nProcessed);
+    }
+    if(m_result.nRejected > 0) {
+      Info(APP_NAME, "Preselection rejected %lli of %lli events (%.1f%%)",
+           m_result.nRejected, m_result.nProcessed,
+           100. * m_result.nRejected / m_result.nProcessed);
+    }
+    if(!m_config.systematics.empty() && m_result.nProcessed > 0) {
+      Info(APP_NAME, "Ran %lli systematic variations (%.1f per event), "
+           "skipped %lli that affect no tool", m_result.nVariations,
+           double(m_result.nVariations) / m_result.nProcessed,
+           m_result.nSkippedVariations);
+    }
+    if(m_config.inputFiles.size() > 1) {
+      Info(APP_NAME, "Waited %.2f s for input files to open",
+           m_fileWaitTime);
+    }
+    Info(APP_NAME, "Processed %lli events in %.2f s (%.1f events/s)",
+         m_result.nProcessed, m_wallTime,
+         m_wallTime > 0 ? m_result.nProcessed / m_wallTime : 0.);
+    if(m_config.benchmark) {
+      Info(APP_NAME, "CP tool setup took %.3f s", m_result.toolSetupTime);
+      m_result.phaseTimes.print(APP_NAME);
+    }
+  }
+
+  StatusCode EventLoop::writeBenchmark(const std::string& fileName) const
+  {
+    const char* APP_NAME = "EventLoop";
+    char buffer[1024];
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\n"
+                  "  \"threads\": %u,\n"
+                  "  \"block_size\": %u,\n"
+                  "  \"access_mode\": \"%s\",\n"
+                  "  \"files\": %u,\n"
+                  "  \"events\": %lli,\n"
+                  "  \"wall_time_s\": %.6f,\n"
+                  "  \"events_per_s\": %.3f,\n"
+                  "  \"tool_setup_s\": %.6f,\n"
+                  "  \"bytes_read\": %lli,\n"
+                  "  \"read_calls\": %lli,\n"
+                  "  \"phases\": ",
+                  m_config.nThreads, m_config.blockSize,
+                  JobConfig::accessModeName(m_config.accessMode),
+                  static_cast<unsigned int>(m_config.inputFiles.size()),
+                  m_result.nProcessed, m_wallTime,
+                  m_wallTime > 0 ? m_result.nProcessed / m_wallTime : 0.,
+                  m_result.toolSetupTime, m_result.readStats.bytesRead,
+                  m_result.readStats.readCalls);
+    std::string json = buffer;
+    m_result.phaseTimes.writeJson(json, "  ");
+    json += "\n}\n";
+
+    FILE* out = std::fopen(fileName.c_str(), "w");
+    if(!out) {
+      Error(APP_NAME, "Can't open benchmark output file: %s",
+            fileName.c_str());
+      return StatusCode::FAILURE;
+    }
+    const bool ok = (std::fputs(json.c_str(), out) >= 0);
+    CPT_RETURN_CHECK( APP_NAME, std::fclose(out) == 0 && ok );
+    Info(APP_NAME, "Benchmark report written to %s", fileName.c_str());
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,93 @@
+// System includes
+#include <algorithm>
+
+// EDM includes
+#include "xAODEventInfo/EventInfo.h"
+
+// Local includes
+#include "CPTutorialExample/EventPreselection.h"
+#include "CPTutorialExample/JobConfig.h"
+
+namespace {
+
+  /// Version of the cuts in EventPreselection::accept()
+  ///
+  /// It's part of the description, so that cached event indices made
+  /// with other cuts are not used.
+  const char* const CUTS_VERSION = "1";
+
+} // private namespace
+
+namespace CPTutorial {
+
+  EventPreselection::EventPreselection(const JobConfig& config)
+    : m_active(false),
+      m_runs(config.runList),
+      m_firstRun(config.firstRun),
+      m_lastRun(config.lastRun),
+      m_grlFiles(config.grlFiles),
+      m_grl()
+  {
+    std::sort(m_runs.begin(), m_runs.end());
+    m_runs.erase(std::unique(m_runs.begin(), m_runs.end()), m_runs.end());
+    m_active = (!m_runs.empty() || m_firstRun > 0 ||
+                m_lastRun < JobConfig::MAX_RUN || !m_grlFiles.empty());
+
+
+
+    // @@@ Set m_active if you add cuts to accept() @@@ //
+
+
+
+  }
+
+  StatusCode EventPreselection::initialize()
+  {
+    for(std::size_t i = 0; i < m_grlFiles.size(); ++i) {
+      if(m_grl.readXml(m_grlFiles[i]).isFailure()) return StatusCode::FAILURE;
+    }
+    m_grl.compile();
+    return StatusCode::SUCCESS;
+  }
+
+  bool EventPreselection::accept(const xAOD::EventInfo& info) const
+  {
+    const UInt_t run = info.runNumber();
+    if(run < m_firstRun || run > m_lastRun) return false;
+    if(!m_runs.empty() &&
+       !std::binary_search(m_runs.begin(), m_runs.end(), run)) {
+      return false;
+    }
+
+    // The good-run list only applies to data
+    if(!m_grlFiles.empty() &&
+       !info.eventType(xAOD::EventInfo::IS_SIMULATION) &&
+       !m_grl.accept(run, info.lumiBlock())) {
+      return false;
+    }
+
+
+
+    // @@@ Add your own EventInfo-only cuts here @@@ //
+    // Change CUTS_VERSION when you do. For example:
+    //   if(info.eventType(xAOD::EventInfo::IS_SIMULATION)) return false;
+
+
+
+    return true;
+  }
+
+  std::string EventPreselection::description() const
+  {
+    std::string result = "version=";
+    result += CUTS_VERSION;
+    result += ";runs=" + std::to_string(m_firstRun) + ":" +
+      std::to_string(m_lastRun);
+    for(std::size_t i = 0; i < m_runs.size(); ++i) {
+      result += (i == 0 ? ";list=" : ",") + std::to_string(m_runs[i]);
+    }
+    if(!m_grlFiles.empty()) result += ";grl=" + m_grl.description();
+    return result;
+  }
+
+} // namespace CPTutorial
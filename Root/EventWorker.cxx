@@ -0,0 +1,688 @@
+// System includes
+#include <algorithm>
+#include <chrono>
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TError.h"
+
+// Infrastructure includes
+#include "xAODRootAccess/TEvent.h"
+#include "xAODRootAccess/TStore.h"
+
+// EDM includes
+#include "xAODEventInfo/EventInfo.h"
+
+// Local includes
+#include "CPTutorialExample/EventWorker.h"
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/EntryScheduler.h"
+#include "CPTutorialExample/ProgressReporter.h"
+#include "CPTutorialExample/StartupTimer.h"
+#include "CPTutorialExample/ResultStream.h"
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  WorkerResult::WorkerResult()
+    : nProcessed(0),
+      nRejected(0),
+      loopTime(0),
+      idleTime(0),
+      nRanges(0),
+      nStolen(0),
+      readStats(),
+      toolSetupTime(0),
+      phaseTimes(),
+      recycling(),
+      nVariations(0),
+      nSkippedVariations(0),
+      allocations(),
+      memory()
+  {}
+
+  WorkerResult& WorkerResult::operator+=(const WorkerResult& rhs)
+  {
+    nProcessed += rhs.nProcessed;
+    nRejected += rhs.nRejected;
+    loopTime += rhs.loopTime;
+    idleTime += rhs.idleTime;
+    nRanges += rhs.nRanges;
+    nStolen += rhs.nStolen;
+    readStats += rhs.readStats;
+    toolSetupTime += rhs.toolSetupTime;
+    phaseTimes += rhs.phaseTimes;
+    recycling += rhs.recycling;
+    nVariations += rhs.nVariations;
+    nSkippedVariations += rhs.nSkippedVariations;
+    allocations += rhs.allocations;
+    memory += rhs.memory;
+    return *this;
+  }
+
+  void WorkerResult::write(ResultWriter& out) const
+  {
+    out.put(nProcessed);
+    out.put(nRejected);
+    out.put(loopTime);
+    out.put(idleTime);
+    out.put(nRanges);
+    out.put(nStolen);
+    out.put(readStats);
+    out.put(toolSetupTime);
+    phaseTimes.write(out);
+    out.put(recycling);
+    out.put(nVariations);
+    out.put(nSkippedVariations);
+    out.put(allocations);
+    memory.write(out);
+  }
+
+  bool WorkerResult::read(ResultReader& in)
+  {
+    return in.get(nProcessed) && in.get(nRejected) && in.get(loopTime) &&
+      in.get(idleTime) && in.get(nRanges) && in.get(nStolen) &&
+      in.get(readStats) && in.get(toolSetupTime) && phaseTimes.read(in) &&
+      in.get(recycling) && in.get(nVariations) &&
+      in.get(nSkippedVariations) && in.get(allocations) && memory.read(in);
+  }
+
+  EventWorker::EventWorker(unsigned int index, const JobConfig& config)
+    : m_index(index),
+      m_name("EventWorker#" + std::to_string(index)),
+      m_config(config),
+      m_file(),
+      m_event(),
+      m_store(),
+      m_recycling(),
+      m_cursor(),
+      m_eventInfo("EventInfo"),
+      m_preselection(config),
+      m_recordAccepted((!config.indexCache.empty() &&
+                        m_preselection.active()) ||
+                       !config.skimOutput.empty()),
+      m_acceptedEntries(),
+      m_systematics(),
+      m_stages(),
+      m_staticChain(),
+      m_toolsReady(false),
+      m_progress(0),
+      m_startup(0),
+      m_memoryMonitor(0),
+      m_fileEntries(0),
+      m_toolsMemory(0),
+      m_block(),
+      m_columnarOutput(0),
+      m_columnBuffer(),
+      m_eventInfoColumns(),
+      m_histograms(),
+      m_eventInfoHistograms(),
+      m_result()
+  {
+    m_toolsMemory = m_result.memory.container("(all CP tools)");
+  }
+
+  EventWorker::~EventWorker()
+  {}
+
+  StatusCode EventWorker::initialize()
+  {
+    // Create a TEvent object
+    m_event.reset(new xAOD::TEvent(m_config.accessMode));
+    m_cursor.setEvent(m_event.get());
+
+    // Create a transient store. With the recycling store the objects of
+    // one event are reset and handed out again in the next one.
+    m_store.reset(new xAOD::TStore());
+    if(m_config.recycleTransients) m_recycling.reset(new RecyclingStore());
+
+    const char* APP_NAME = m_name.c_str();
+    CPT_RETURN_CHECK( APP_NAME, m_preselection.initialize() );
+    if(!m_config.lazyInit) CPT_RETURN_CHECK( APP_NAME, initializeTools() );
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::initializeTools()
+  {
+    const char* APP_NAME = m_name.c_str();
+    PhaseClock clock;
+
+    CPT_RETURN_CHECK( APP_NAME, m_staticChain.initialize() );
+
+    // The stages of the tool configuration. Disabled ones were dropped
+    // when reading it, so they are never constructed.
+    m_stages.clear();
+    for(std::size_t i = 0; i < m_config.tools.size(); ++i) {
+      // A copy of the configuration, as it remembers the properties
+      // read, and the workers set up their stages concurrently
+      const ToolConfig config = m_config.tools[i];
+      Stage s;
+      s.stage = ToolStageFactory::create(config.type);
+      s.name = config.name;
+      CPT_RETURN_CHECK( APP_NAME, s.stage.get() );
+      CPT_RETURN_CHECK( APP_NAME, s.stage->initialize(config) );
+      const std::vector<std::string> unread = config.unreadProperties();
+      if(!unread.empty()) {
+        std::string names;
+        for(std::size_t j = 0; j < unread.size(); ++j) {
+          names += (j > 0 ? ", " : "") + unread[j];
+        }
+        Error(APP_NAME, "Tool %s doesn't know the properties: %s",
+              s.name.c_str(), names.c_str());
+        return StatusCode::FAILURE;
+      }
+      if(s.stage->readsContainer() && config.container.empty()) {
+        Error(APP_NAME, "Tool %s reads a container, but its configuration "
+              "doesn't name one with \"container\"", s.name.c_str());
+        return StatusCode::FAILURE;
+      }
+      CP::ISystematicsTool* tool = s.stage->systematicsTool();
+      s.systematic = (tool != 0);
+      s.container = std::string::npos;
+      if(tool && !config.container.empty()) {
+        s.container = m_systematics.addTool(tool, config.container);
+      } else if(tool) {
+        m_systematics.addTool(tool);
+      }
+      m_stages.push_back(std::move(s));
+    }
+
+    // Stages reading a container follow its variations, once all tools
+    // calibrating it are registered
+    for(std::size_t i = 0; i < m_stages.size(); ++i) {
+      const std::string& container = m_config.tools[i].container;
+      if(!m_stages[i].systematic && !container.empty()) {
+        m_stages[i].container = m_systematics.findContainer(container);
+      }
+    }
+
+
+
+    // @@@ Create and configure your CP tools here @@@ //
+    // Tools can also be wrapped in a ToolStage, registered with
+    // CPT_REGISTER_TOOL_STAGE, and set up from the --tool-config file
+    // without recompiling. Each worker needs its own tool instances,
+    // since the tools are not shared between threads. Tools with
+    // systematics are registered with the driver, together with the
+    // container they calibrate, e.g.:
+    //   m_jetContainer = m_systematics.addTool(&m_jetCalibTool, "CalibJets");
+    // With --memory-report the memory of the containers you make is
+    // reported under keys declared here, e.g.:
+    //   m_jetMemory = m_result.memory.container("CalibJets");
+
+
+
+    CPT_RETURN_CHECK( APP_NAME,
+                      m_systematics.initialize(m_config.systematics) );
+    m_toolsReady = true;
+    m_result.toolSetupTime += clock.lap();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::openFile(const std::string& fileName)
+  {
+    const char* APP_NAME = m_name.c_str();
+
+    // Open the input file
+    Info(APP_NAME, "Opening file: %s", fileName.c_str());
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+    CPT_RETURN_CHECK( APP_NAME, file.get() );
+    return setInput(std::move(file));
+  }
+
+  StatusCode EventWorker::setInput(std::unique_ptr<TFile> file)
+  {
+    const char* APP_NAME = m_name.c_str();
+    CPT_RETURN_CHECK( APP_NAME, file.get() );
+
+    // Connect the event to the new file before closing the old one
+    const ReadCacheConfig& cache = m_config.readCache;
+    CPT_RETURN_CHECK( APP_NAME,
+                      m_event->readFrom(file.get(), cache.cacheSize != 0) );
+    closeFile();
+    m_file = std::move(file);
+
+    // Replace TEvent's default cache settings with ours
+    TTree* tree = inputTree();
+    if(tree) configureReadCache(*tree, cache);
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::finalize()
+  {
+    const char* APP_NAME = m_name.c_str();
+    if(m_columnBuffer) {
+      CPT_RETURN_CHECK( APP_NAME, m_columnarOutput->write(*m_columnBuffer) );
+    }
+    closeFile();
+    if(m_recycling) m_result.recycling = m_recycling->stats();
+    return StatusCode::SUCCESS;
+  }
+
+  void EventWorker::declareColumns(ColumnSchema& schema)
+  {
+    schema.add("runNumber", kUIntColumn);
+    schema.add("eventNumber", kULong64Column);
+    schema.add("lumiBlock", kUIntColumn);
+    schema.add("averageInteractionsPerCrossing", kFloatColumn);
+    schema.add("mcEventWeight", kFloatColumn);
+
+
+
+    // @@@ Declare your own output columns here, e.g. @@@ //
+    //   schema.add("jet_pt", kFloatArrayColumn);
+
+
+
+  }
+
+  void EventWorker::setColumnarOutput(ColumnarOutput* output)
+  {
+    m_columnarOutput = output;
+    if(!output) {
+      m_columnBuffer.reset();
+      return;
+    }
+    const ColumnSchema& schema = output->schema();
+    m_columnBuffer.reset(new ColumnBuffer(schema));
+    m_eventInfoColumns.runNumber = schema.index("runNumber");
+    m_eventInfoColumns.eventNumber = schema.index("eventNumber");
+    m_eventInfoColumns.lumiBlock = schema.index("lumiBlock");
+    m_eventInfoColumns.averageMu =
+      schema.index("averageInteractionsPerCrossing");
+    m_eventInfoColumns.mcEventWeight = schema.index("mcEventWeight");
+  }
+
+  void EventWorker::declareHistograms(HistogramBook& book)
+  {
+    book.book("averageInteractionsPerCrossing",
+              "Average interactions per crossing", 100, 0., 100.);
+
+
+
+    // @@@ Book your own histograms here, e.g. @@@ //
+    //   book.book("jet_pt", "Jet p_{T} [MeV]", 100, 0., 500000.);
+
+
+
+  }
+
+  void EventWorker::setHistograms(const HistogramBook* book)
+  {
+    if(!book) {
+      m_histograms.reset();
+      return;
+    }
+    m_histograms.reset(new HistogramAccumulator(*book));
+    m_eventInfoHistograms.averageMu =
+      book->index("averageInteractionsPerCrossing");
+  }
+
+  void EventWorker::takeAcceptedEntries(std::vector<Long64_t>& entries)
+  {
+    entries.insert(entries.end(), m_acceptedEntries.begin(),
+                   m_acceptedEntries.end());
+    m_acceptedEntries.clear();
+  }
+
+  void EventWorker::closeFile()
+  {
+    if(!m_file) return;
+    TTree* tree = inputTree();
+    m_result.readStats.addFile(*m_file, tree);
+    if(m_config.memoryReport && tree) {
+      m_result.memory.addInput(*tree, m_fileEntries);
+    }
+    m_fileEntries = 0;
+    m_file.reset();
+  }
+
+  void EventWorker::setActive()
+  {
+    // Make this worker's event and store the ones the tools see. Note
+    // that the active event/store are only thread-local in releases
+    // where xAODRootAccess supports multi-threaded use.
+    m_event->setActive();
+    m_store->setActive();
+  }
+
+  StatusCode EventWorker::processRange(Long64_t begin, Long64_t end)
+  {
+    setActive();
+
+    const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    if(executeEntries(begin, end).isFailure()) return StatusCode::FAILURE;
+    m_result.loopTime += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    ++m_result.nRanges;
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::process(EntryScheduler& scheduler)
+  {
+    typedef std::chrono::steady_clock clock;
+    setActive();
+
+    const clock::time_point start = clock::now();
+    EntryGroup group;
+    bool stolen = false;
+    while(true) {
+      const clock::time_point wait = clock::now();
+      const bool more = scheduler.next(m_index, group, stolen);
+      m_result.idleTime +=
+        std::chrono::duration<double>(clock::now() - wait).count();
+      if(!more) break;
+
+      ++m_result.nRanges;
+      if(stolen) ++m_result.nStolen;
+      for(std::size_t i = 0; i < group.size(); ++i) {
+        if(executeEntries(group[i].begin, group[i].end).isFailure()) {
+          return StatusCode::FAILURE;
+        }
+      }
+    }
+    m_result.loopTime +=
+      std::chrono::duration<double>(clock::now() - start).count();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::execute(Long64_t entry)
+  {
+    return executeBlock(entry, entry + 1);
+  }
+
+  StatusCode EventWorker::executeEntries(Long64_t begin, Long64_t end)
+  {
+    const Long64_t blockSize = m_config.blockSize;
+    for(Long64_t first = begin; first < end; first += blockSize) {
+      const Long64_t last = std::min(end, first + blockSize);
+      if(executeBlock(first, last).isFailure()) return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::executeBlock(Long64_t begin, Long64_t end)
+  {
+    const char* APP_NAME = m_name.c_str();
+
+    // In benchmark mode every phase of the block is timed
+    PhaseTimer timer(m_config.benchmark, m_result.phaseTimes);
+    CPT_RETURN_CHECK( APP_NAME, loadBlock(begin, end, m_block, timer) );
+    CPT_RETURN_CHECK( APP_NAME, finishBlock(m_block, timer) );
+    timer.endEvents(m_block.nEntries);
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::loadBlock(Long64_t begin, Long64_t end,
+                                    EventBlock& block, PhaseTimer& timer)
+  {
+    const char* APP_NAME = m_name.c_str();
+
+    // The per-event stages, which need the entry to be loaded
+    const AllocationCount allocStart = threadAllocations();
+    block.clear();
+    for(Long64_t entry = begin; entry < end; ++entry) {
+
+      // Tell TEvent which entry to use
+      m_event->getEntry(entry);
+      m_cursor.nextEntry();
+      timer.endPhase(PhaseTimes::GetEntry);
+
+      // Retrieve basic event information, through a handle that hashed
+      // its key once for the whole job
+      const xAOD::EventInfo* evtInfo = m_eventInfo.get(m_cursor);
+      CPT_RETURN_CHECK( APP_NAME, evtInfo );
+      timer.endPhase(PhaseTimes::Retrieve);
+
+      // Printing every event is only for debugging, progress is normally
+      // reported by the rate-limited ProgressReporter
+      if(m_config.printEvents) {
+        Info(APP_NAME,
+             "===>>> Processing event #%llu, "
+             "run #%u, entry #%lli  <<<===",
+             static_cast<unsigned long long>(evtInfo->eventNumber()),
+             evtInfo->runNumber(), entry);
+        timer.endPhase(PhaseTimes::Event);
+      }
+      ++block.nEntries;
+
+      // Cut on EventInfo before anything else of the event is read
+      const bool rejected =
+        m_preselection.active() && !m_preselection.accept(*evtInfo);
+      timer.endPhase(PhaseTimes::Preselect);
+      if(rejected) {
+        ++m_result.nRejected;
+        continue;
+      }
+      if(m_recordAccepted) m_acceptedEntries.push_back(entry);
+
+      // With lazy initialisation the tools are set up here, once they
+      // are needed. Jobs where no event passes never set them up.
+      if(!m_toolsReady) CPT_RETURN_CHECK( APP_NAME, initializeTools() );
+
+      // Run the CP tools once per systematic set. The entry was read only
+      // once, all variations share the input containers. Sets that affect
+      // none of the tools give the nominal result and are skipped.
+      {
+        AllocationScope toolsMemory(m_result.memory, m_toolsMemory);
+        EventBlock* stageBlock = (m_config.blockSize > 1 ? &block : 0);
+        for(std::size_t sys = 0; sys < m_systematics.size(); ++sys) {
+          if(!m_systematics.affectsAny(sys)) {
+            ++m_result.nSkippedVariations;
+            continue;
+          }
+          CPT_RETURN_CHECK( APP_NAME, m_systematics.apply(sys) );
+          CPT_RETURN_CHECK( APP_NAME,
+                            executeSystematic(*evtInfo, sys, stageBlock) );
+          ++m_result.nVariations;
+        }
+      }
+
+      // Keep what the block stages and the output need
+      block.push(entry, *evtInfo);
+
+
+
+      // @@@ Gather the variables of your block stages here, e.g. @@@ //
+      //   block.jets.gather(*jets);
+
+
+
+      timer.endPhase(PhaseTimes::Tools);
+
+      // Clear the transient store
+      m_store->clear();
+      if(m_recycling) m_recycling->clear();
+      timer.endPhase(PhaseTimes::Clear);
+    }
+    m_fileEntries += block.nEntries;
+    if(m_config.memoryReport) {
+      countAllocations(threadAllocations() - allocStart, 0);
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::finishBlock(EventBlock& block, PhaseTimer& timer)
+  {
+    const char* APP_NAME = m_name.c_str();
+
+    // The stages running over the whole block at once
+    const AllocationCount allocStart = threadAllocations();
+    CPT_RETURN_CHECK( APP_NAME, executeBlockStages(block) );
+    timer.endPhase(PhaseTimes::Block);
+
+    // Fill the columnar output
+    if(m_columnBuffer) {
+      CPT_RETURN_CHECK( APP_NAME, fillColumns(block) );
+    }
+    if(m_histograms) fillHistograms(block);
+    timer.endPhase(PhaseTimes::Event);
+
+    if(m_config.memoryReport) {
+      countAllocations(threadAllocations() - allocStart, block.nEntries);
+    }
+    m_result.nProcessed += block.nEntries;
+    if(m_progress) m_progress->count(block.nEntries);
+    if(m_startup) {
+      m_startup->markOnce("First block of events");
+      m_startup = 0;
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  void EventWorker::countAllocations(const AllocationCount& count,
+                                     Long64_t nEvents)
+  {
+    m_result.allocations += count;
+    if(m_memoryMonitor) m_memoryMonitor->add(count, nEvents);
+  }
+
+  StatusCode EventWorker::executeBlockStages(EventBlock& block)
+  {
+    const char* APP_NAME = m_name.c_str();
+
+    // The configured stages that gathered from the events of the block
+    for(std::size_t i = 0; i < m_stages.size(); ++i) {
+      const Stage& s = m_stages[i];
+      if(CPT_UNLIKELY(s.stage->executeBlock(block).isFailure())) {
+        Error(APP_NAME, "Tool %s failed on the block", s.name.c_str());
+        return StatusCode::FAILURE;
+      }
+    }
+
+
+
+    // @@@ Run your block-level stages here @@@ //
+    // Everything gathered from the events of the block is in "block",
+    // e.g.:
+    //   m_jetPt.resize(block.jets.size());
+    //   m_jetKernel.apply(block.jets, m_jetPt.data());
+    // The TEvent has moved on to the last entry of the block already.
+
+
+
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode EventWorker::fillColumns(const EventBlock& block)
+  {
+    const char* APP_NAME = m_name.c_str();
+    ColumnBuffer& row = *m_columnBuffer;
+    const EventInfoColumns& col = m_eventInfoColumns;
+    for(std::size_t i = 0; i < block.size(); ++i) {
+      row.set<UInt_t>(col.runNumber, block.runNumber[i]);
+      row.set<ULong64_t>(col.eventNumber, block.eventNumber[i]);
+      row.set<UInt_t>(col.lumiBlock, block.lumiBlock[i]);
+      row.set<Float_t>(col.averageMu, block.averageMu[i]);
+      row.set<Float_t>(col.mcEventWeight, block.mcEventWeight[i]);
+
+      // @@@ Fill your own output columns here @@@ //
+
+      row.endRow();
+    }
+    if(Long64_t(row.rows()) >= m_config.columnarFlushRows) {
+      CPT_RETURN_CHECK( APP_NAME, m_columnarOutput->write(row) );
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  void EventWorker::fillHistograms(const EventBlock& block)
+  {
+    // One batched fill per histogram and block, into this worker's own
+    // buffer
+    HistogramAccumulator& hist = *m_histograms;
+    hist.fill(m_eventInfoHistograms.averageMu, block.size(),
+              block.averageMu.data(), block.mcEventWeight.data());
+
+
+
+    // @@@ Fill your own histograms here, e.g. @@@ //
+    //   hist.fill(m_jetPtHistogram, m_jetPt.size(), m_jetPt.data());
+    // The results of the configured block stages are the object columns
+    // in block.objects, by output name.
+
+
+
+  }
+
+  StatusCode EventWorker::executeSystematic(const xAOD::EventInfo& evtInfo,
+                                            std::size_t sys,
+                                            EventBlock* block)
+  {
+    const char* APP_NAME = m_name.c_str();
+
+    // The compiled-in stages, then the configured ones. Configured
+    // stages run for the nominal set, and for the others when the set
+    // changes the container they calibrate or read. Stages with neither
+    // systematics nor a varied input give the nominal result for every
+    // set, so they only run for the nominal one.
+    ToolContext context = { *m_event, m_cursor, *m_store, m_recycling.get(),
+                            m_systematics, sys, evtInfo, block };
+    if(CPT_UNLIKELY(!m_staticChain.execute(context))) {
+      Error(APP_NAME, "Stage %s failed", m_staticChain.failedStageName());
+      return StatusCode::FAILURE;
+    }
+    for(std::size_t i = 0; i < m_stages.size(); ++i) {
+      const Stage& s = m_stages[i];
+      if(sys != 0) {
+        if(s.container == std::string::npos) {
+          if(!s.systematic) continue;
+        }
+        else if(!m_systematics.needsUpdate(s.container, sys)) {
+          continue;
+        }
+      }
+      if(CPT_UNLIKELY(s.stage->execute(context).isFailure())) {
+        Error(APP_NAME, "Tool %s failed", s.name.c_str());
+        return StatusCode::FAILURE;
+      }
+    }
+
+
+
+    // @@@ Call your CP tools here @@@ //
+    // The tools are already switched to the systematic set "sys". Every
+    // variation makes its own shallow copy of the shared input, under
+    // its own key, unless the set leaves the container unchanged. Its
+    // key then names the copy made for an earlier set. With
+    // --transient-store arena the copies are kept across events instead
+    // of being rebuilt every time. Retrieve the inputs through a
+    // ContainerHandle member, which hashes its key only once, e.g.:
+    //   const xAOD::JetContainer* inputJets = m_inputJets.get(m_cursor);
+    //   const std::string& key =
+    //     m_systematics.containerKey(m_jetContainer, sys);
+    //   if(m_systematics.needsUpdate(m_jetContainer, sys)) {
+    //     xAOD::JetContainer* jets =
+    //       recycledShallowCopy(*m_recycling, *inputJets, key);
+    //     ...
+    //   }
+    // Corrections that need only a few variables of each object can be
+    // run on the whole container at once with BatchCalibration.h,
+    // instead of one tool call per object:
+    //   m_jetBatch.clear();
+    //   const std::size_t offset = m_jetBatch.gather(*jets);
+    //   m_jetPt.resize(m_jetBatch.size());
+    //   m_jetKernel.apply(m_jetBatch, m_jetPt.data());
+    //   scatter(*jets, offset, m_jetPt.data(), m_jetPtDecorator);
+    // The allocations made while a container is built are charged to it
+    // by an AllocationScope:
+    //   AllocationScope jetMemory(m_result.memory, m_jetMemory);
+
+
+
+    return StatusCode::SUCCESS;
+  }
+
+  TTree* EventWorker::inputTree() const
+  {
+    return m_file ? dynamic_cast<TTree*>(m_file->Get("CollectionTree")) : 0;
+  }
+
+  Long64_t EventWorker::entries() const
+  {
+    return m_event ? m_event->getEntries() : 0;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,70 @@
+// System includes
+#include <chrono>
+
+// ROOT includes
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/FilePrefetcher.h"
+
+namespace CPTutorial {
+
+  FilePrefetcher::FilePrefetcher(bool async)
+    : m_async(async),
+      m_fileName(),
+      m_pending(),
+      m_waitTime(0)
+  {
+    // Files are opened on another thread than the one reading them
+    if(m_async) ROOT::EnableThreadSafety();
+  }
+
+  FilePrefetcher::~FilePrefetcher()
+  {
+    // Don't leak a file nobody asked for
+    if(m_pending.valid()) delete m_pending.get();
+  }
+
+  void FilePrefetcher::prefetch(const std::string& fileName)
+  {
+    if(m_pending.valid()) delete m_pending.get();
+    m_fileName = fileName;
+    if(m_async) {
+      m_pending = std::async(std::launch::async, &FilePrefetcher::openFile,
+                             fileName);
+    }
+  }
+
+  std::unique_ptr<TFile> FilePrefetcher::take()
+  {
+    const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    std::unique_ptr<TFile> file(m_pending.valid() ? m_pending.get() :
+                                openFile(m_fileName));
+    m_waitTime += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    return file;
+  }
+
+  TFile* FilePrefetcher::openFile(const std::string& fileName)
+  {
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+    if(!file.get() || file->IsZombie()) {
+      ::Error("FilePrefetcher", "Failed to open file: %s", fileName.c_str());
+      return 0;
+    }
+
+    // Read the tree headers now, TFile::Get() hands the same in-memory
+    // objects to TEvent later on. Reading the first metadata entry pulls
+    // in the EventFormat object TEvent needs to set up its branches.
+    file->Get("CollectionTree");
+    TTree* metaTree = dynamic_cast<TTree*>(file->Get("MetaData"));
+    if(metaTree && metaTree->GetEntries() > 0) metaTree->GetEntry(0);
+
+    return file.release();
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,72 @@
+// System includes
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/ForkedProcess.h"
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  StatusCode runForked(const std::function<StatusCode()>& func,
+                       void* data, std::size_t size, double* peakRss)
+  {
+    const char* APP_NAME = "runForked";
+    int fds[2];
+    CPT_RETURN_CHECK( APP_NAME, ::pipe(fds) == 0 );
+
+    // Whatever is buffered would otherwise be written by both processes
+    std::fflush(stdout);
+    std::fflush(stderr);
+    const pid_t pid = ::fork();
+    if(pid < 0) {
+      Error(APP_NAME, "Can't fork a process");
+      ::close(fds[0]);
+      ::close(fds[1]);
+      return StatusCode::FAILURE;
+    }
+    if(pid == 0) {
+      ::close(fds[0]);
+      bool ok = func().isSuccess();
+      if(ok) {
+        ok = (::write(fds[1], data, size) == static_cast<ssize_t>(size));
+      }
+      ::close(fds[1]);
+      std::fflush(stdout);
+      std::fflush(stderr);
+      ::_exit(ok ? EXIT_SUCCESS : 1);
+    }
+
+    // The result is read before waiting, so that a large one can't
+    // block the child on a full pipe
+    ::close(fds[1]);
+    const bool reported =
+      (::read(fds[0], data, size) == static_cast<ssize_t>(size));
+    ::close(fds[0]);
+    int status = 0;
+    struct rusage usage;
+    const bool exited = (::wait4(pid, &status, 0, &usage) == pid &&
+                         WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    if(!reported || !exited) {
+      Error(APP_NAME, "The forked process failed");
+      return StatusCode::FAILURE;
+    }
+    if(peakRss) {
+#ifdef __APPLE__
+      // Reported in bytes on OS X...
+      *peakRss = usage.ru_maxrss / 1024. / 1024.;
+#else
+      // ...and in kilobytes on Linux
+      *peakRss = usage.ru_maxrss / 1024.;
+#endif
+    }
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,190 @@
+// System includes
+#include <algorithm>
+#include <cstdlib>
+
+// ROOT includes
+#include "TError.h"
+#include "TXMLEngine.h"
+
+// Local includes
+#include "CPTutorialExample/GoodRunsList.h"
+
+namespace {
+
+  /// Parse an unsigned number of a GRL file, false if it isn't one
+  bool parseNumber(const char* text, UInt_t& result)
+  {
+    if(!text || !*text) return false;
+    char* end = 0;
+    const unsigned long value = std::strtoul(text, &end, 10);
+    if(*end != '\0' || value > 0xfffffffful) return false;
+    result = static_cast<UInt_t>(value);
+    return true;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  const std::size_t GoodRunsList::NO_RUN;
+  const UInt_t GoodRunsList::MAX_LB;
+
+  bool GoodRunsList::Range::operator<(const Range& rhs) const
+  {
+    if(run != rhs.run) return run < rhs.run;
+    if(firstLB != rhs.firstLB) return firstLB < rhs.firstLB;
+    return lastLB < rhs.lastLB;
+  }
+
+  GoodRunsList::GoodRunsList()
+    : m_ranges(),
+      m_runs(),
+      m_bits(),
+      m_lastRun(0),
+      m_lastIndex(NO_RUN)
+  {}
+
+  void GoodRunsList::addRange(UInt_t run, UInt_t firstLB, UInt_t lastLB)
+  {
+    lastLB = std::min(lastLB, MAX_LB);
+    if(lastLB < firstLB) return;
+    Range range;
+    range.run = run;
+    range.firstLB = firstLB;
+    range.lastLB = lastLB;
+    m_ranges.push_back(range);
+  }
+
+  StatusCode GoodRunsList::readXml(const std::string& fileName)
+  {
+    TXMLEngine xml;
+    XMLDocPointer_t doc = xml.ParseFile(fileName.c_str());
+    if(!doc) {
+      ::Error("GoodRunsList::readXml", "Can't parse GRL file %s",
+              fileName.c_str());
+      return StatusCode::FAILURE;
+    }
+
+    // LumiRangeCollection / NamedLumiRange / LumiBlockCollection, each
+    // collection holding a Run and its LBRange elements
+    bool ok = true;
+    std::size_t nRanges = 0;
+    XMLNodePointer_t root = xml.DocGetRootElement(doc);
+    for(XMLNodePointer_t named = xml.GetChild(root); named && ok;
+        named = xml.GetNext(named)) {
+      if(std::string(xml.GetNodeName(named)) != "NamedLumiRange") continue;
+      for(XMLNodePointer_t coll = xml.GetChild(named); coll && ok;
+          coll = xml.GetNext(coll)) {
+        if(std::string(xml.GetNodeName(coll)) != "LumiBlockCollection") {
+          continue;
+        }
+        UInt_t run = 0;
+        bool haveRun = false;
+        std::vector<std::pair<UInt_t, UInt_t> > ranges;
+        for(XMLNodePointer_t node = xml.GetChild(coll); node && ok;
+            node = xml.GetNext(node)) {
+          const std::string name = xml.GetNodeName(node);
+          if(name == "Run") {
+            haveRun = ok = parseNumber(xml.GetNodeContent(node), run);
+          }
+          else if(name == "LBRange") {
+            UInt_t start = 0, end = 0;
+            ok = (parseNumber(xml.GetAttr(node, "Start"), start) &&
+                  parseNumber(xml.GetAttr(node, "End"), end));
+            ranges.push_back(std::make_pair(start, end));
+          }
+        }
+        if(ok && !haveRun && !ranges.empty()) ok = false;
+        for(std::size_t i = 0; ok && i < ranges.size(); ++i) {
+          addRange(run, ranges[i].first, ranges[i].second);
+          ++nRanges;
+        }
+      }
+    }
+    xml.FreeDoc(doc);
+
+    if(!ok) {
+      ::Error("GoodRunsList::readXml", "Malformed GRL file %s",
+              fileName.c_str());
+      return StatusCode::FAILURE;
+    }
+    ::Info("GoodRunsList::readXml", "Read %u lumiblock ranges from %s",
+           static_cast<unsigned int>(nRanges), fileName.c_str());
+    return StatusCode::SUCCESS;
+  }
+
+  void GoodRunsList::compile()
+  {
+    std::sort(m_ranges.begin(), m_ranges.end());
+    m_runs.clear();
+    m_bits.clear();
+
+    for(std::size_t first = 0; first < m_ranges.size(); ) {
+      // The ranges of one run
+      std::size_t last = first;
+      UInt_t maxLB = m_ranges[first].lastLB;
+      while(last + 1 < m_ranges.size() &&
+            m_ranges[last + 1].run == m_ranges[first].run) {
+        ++last;
+        maxLB = std::max(maxLB, m_ranges[last].lastLB);
+      }
+
+      RunEntry entry;
+      entry.run = m_ranges[first].run;
+      entry.firstLB = m_ranges[first].firstLB;
+      entry.nLB = maxLB - entry.firstLB + 1;
+      entry.offset = m_bits.size();
+      m_bits.resize(m_bits.size() + (entry.nLB + 63) / 64, 0);
+      for(std::size_t i = first; i <= last; ++i) {
+        for(UInt_t lb = m_ranges[i].firstLB; lb <= m_ranges[i].lastLB; ++lb) {
+          const UInt_t bit = lb - entry.firstLB;
+          m_bits[entry.offset + (bit >> 6)] |= 1ull << (bit & 63);
+        }
+      }
+      m_runs.push_back(entry);
+      first = last + 1;
+    }
+
+    // Start with a valid cache, in case the list has run 0
+    findRun(0);
+  }
+
+  bool GoodRunsList::findRun(UInt_t run) const
+  {
+    std::size_t low = 0, high = m_runs.size();
+    while(low < high) {
+      const std::size_t mid = (low + high) / 2;
+      if(m_runs[mid].run < run) low = mid + 1;
+      else high = mid;
+    }
+    m_lastRun = run;
+    m_lastIndex = (low < m_runs.size() && m_runs[low].run == run) ?
+      low : NO_RUN;
+    return m_lastIndex != NO_RUN;
+  }
+
+  std::string GoodRunsList::description() const
+  {
+    // The merged ranges of every run, independent of how they were given
+    std::string result;
+    for(std::size_t r = 0; r < m_runs.size(); ++r) {
+      const RunEntry& entry = m_runs[r];
+      result += std::to_string(entry.run) + ":";
+      bool inRange = false;
+      for(UInt_t bit = 0; bit <= entry.nLB; ++bit) {
+        const bool good = bit < entry.nLB &&
+          ((m_bits[entry.offset + (bit >> 6)] >> (bit & 63)) & 1);
+        if(good && !inRange) {
+          result += std::to_string(entry.firstLB + bit) + "-";
+        }
+        else if(!good && inRange) {
+          result += std::to_string(entry.firstLB + bit - 1) + ",";
+        }
+        inRange = good;
+      }
+      result += ";";
+    }
+    return result;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,184 @@
+// System includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// ROOT includes
+#include "TFile.h"
+#include "TH1.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/Histograms.h"
+#include "CPTutorialExample/OutputConfig.h"
+#include "CPTutorialExample/Check.h"
+
+namespace {
+
+  /// Doubles per cache line
+  const std::size_t LINE_DOUBLES = 64 / sizeof(double);
+
+  /// Round a buffer size up to whole cache lines
+  std::size_t roundToLine(std::size_t n)
+  {
+    return (n + LINE_DOUBLES - 1) / LINE_DOUBLES * LINE_DOUBLES;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  const std::size_t HistogramBook::npos;
+
+  HistogramBook::HistogramBook()
+    : m_definitions(),
+      m_bufferSize(0)
+  {}
+
+  std::size_t HistogramBook::book(const std::string& name,
+                                  const std::string& title,
+                                  unsigned int nBins, double low,
+                                  double high)
+  {
+    const std::size_t existing = index(name);
+    if(existing != npos) {
+      ::Warning("HistogramBook", "Histogram %s booked twice", name.c_str());
+      return existing;
+    }
+    Definition def;
+    def.name = name;
+    def.title = title;
+    def.nBins = std::max(1u, nBins);
+    def.low = low;
+    def.high = high;
+    def.scale = (high > low ? def.nBins / (high - low) : 0.);
+    def.offset = m_bufferSize;
+    m_bufferSize += roundToLine(HistogramAccumulator::kHeader +
+                                2 * (def.nBins + 2));
+    m_definitions.push_back(def);
+    return m_definitions.size() - 1;
+  }
+
+  std::size_t HistogramBook::index(const std::string& name) const
+  {
+    for(std::size_t i = 0; i < m_definitions.size(); ++i) {
+      if(m_definitions[i].name == name) return i;
+    }
+    return npos;
+  }
+
+  StatusCode HistogramBook::write(
+    const std::string& fileName,
+    const std::vector<const HistogramAccumulator*>& acc,
+    const OutputConfig& output) const
+  {
+    const char* APP_NAME = "HistogramBook";
+
+    // The workers are done, so their buffers are read without locking
+    HistogramAccumulator total(*this);
+    for(std::size_t i = 0; i < acc.size(); ++i) {
+      if(acc[i]) total.add(*acc[i]);
+    }
+
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "RECREATE"));
+    CPT_RETURN_CHECK( APP_NAME, file.get() && !file->IsZombie() );
+    configureOutputFile(*file, output);
+    for(std::size_t i = 0; i < m_definitions.size(); ++i) {
+      const Definition& def = m_definitions[i];
+      const double* h = total.data(i);
+      TH1D hist(def.name.c_str(), def.title.c_str(), def.nBins, def.low,
+                def.high);
+      hist.SetDirectory(0);
+      hist.Sumw2();
+      const double* c = h + HistogramAccumulator::kHeader;
+      for(unsigned int bin = 0; bin < def.nBins + 2; ++bin) {
+        hist.SetBinContent(bin, c[2 * bin]);
+        hist.SetBinError(bin, std::sqrt(c[2 * bin + 1]));
+      }
+      hist.SetEntries(h[HistogramAccumulator::kEntries]);
+      Double_t stats[4] = {
+        h[HistogramAccumulator::kSumW], h[HistogramAccumulator::kSumW2],
+        h[HistogramAccumulator::kSumWX], h[HistogramAccumulator::kSumWX2]
+      };
+      hist.PutStats(stats);
+      CPT_RETURN_CHECK( APP_NAME, file->WriteTObject(&hist) > 0 );
+    }
+    file->Close();
+    Info(APP_NAME, "Wrote %u histograms to %s",
+         static_cast<unsigned int>(m_definitions.size()), fileName.c_str());
+    return StatusCode::SUCCESS;
+  }
+
+  HistogramAccumulator::HistogramAccumulator(const HistogramBook& book)
+    : m_book(book),
+      m_binning(book.size()),
+      m_memory(new double[book.bufferSize() + LINE_DOUBLES]),
+      m_data(0)
+  {
+    for(std::size_t i = 0; i < book.size(); ++i) {
+      const HistogramBook::Definition& def = book.definition(i);
+      Binning& b = m_binning[i];
+      b.low = def.low;
+      b.high = def.high;
+      b.scale = def.scale;
+      b.nBins = def.nBins;
+      b.offset = def.offset;
+    }
+
+    // Start the buffer on a cache line, so that no line is shared with
+    // the data of another thread
+    const std::uintptr_t address =
+      reinterpret_cast<std::uintptr_t>(m_memory.get());
+    const std::uintptr_t mask = LINE_DOUBLES * sizeof(double) - 1;
+    m_data = reinterpret_cast<double*>((address + mask) & ~mask);
+    clear();
+  }
+
+  void HistogramAccumulator::fill(std::size_t id, std::size_t n,
+                                  const Float_t* x, const Float_t* w)
+  {
+    // The binning stays in registers for the whole batch
+    const Binning& b = m_binning[id];
+    const double low = b.low, high = b.high, scale = b.scale;
+    const std::size_t nBins = b.nBins;
+    double* h = m_data + b.offset;
+    double* c = h + kHeader;
+    double sumW = 0, sumW2 = 0, sumWX = 0, sumWX2 = 0;
+    for(std::size_t i = 0; i < n; ++i) {
+      const double xi = x[i];
+      const double wi = w ? w[i] : 1.;
+      std::size_t bin = 0;
+      if(xi >= high) {
+        bin = nBins + 1;
+      } else if(xi >= low) {
+        bin = 1 + static_cast<std::size_t>((xi - low) * scale);
+        if(bin > nBins) bin = nBins;
+        sumW += wi;
+        sumW2 += wi * wi;
+        sumWX += wi * xi;
+        sumWX2 += wi * xi * xi;
+      }
+      c[2 * bin] += wi;
+      c[2 * bin + 1] += wi * wi;
+    }
+    h[kEntries] += n;
+    h[kSumW] += sumW;
+    h[kSumW2] += sumW2;
+    h[kSumWX] += sumWX;
+    h[kSumWX2] += sumWX2;
+  }
+
+  void HistogramAccumulator::add(const HistogramAccumulator& rhs)
+  {
+    const std::size_t n = m_book.bufferSize();
+    double* __restrict__ out = m_data;
+    const double* __restrict__ in = rhs.m_data;
+    for(std::size_t i = 0; i < n; ++i) out[i] += in[i];
+  }
+
+  void HistogramAccumulator::clear()
+  {
+    std::fill(m_data, m_data + m_book.bufferSize(), 0.);
+  }
+
+} // namespace CPTutorial
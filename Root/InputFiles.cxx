@@ -0,0 +1,63 @@
+// System includes
+#include <glob.h>
+#include <fstream>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/InputFiles.h"
+
+namespace CPTutorial {
+
+  bool expandInputPattern(const std::string& pattern,
+                          std::vector<std::string>& files)
+  {
+    // Only local patterns can be expanded
+    if(pattern.find_first_of("*?[") == std::string::npos ||
+       pattern.find("://") != std::string::npos) {
+      files.push_back(pattern);
+      return true;
+    }
+
+    glob_t matches;
+    if(::glob(pattern.c_str(), 0, 0, &matches) != 0) {
+      ::Error("expandInputPattern", "No files match \"%s\"",
+              pattern.c_str());
+      ::globfree(&matches);
+      return false;
+    }
+    // glob() returns the matches in sorted order
+    for(std::size_t i = 0; i < matches.gl_pathc; ++i) {
+      files.push_back(matches.gl_pathv[i]);
+    }
+    ::globfree(&matches);
+    return true;
+  }
+
+  bool readInputFileList(const std::string& listFile,
+                         std::vector<std::string>& files)
+  {
+    std::ifstream in(listFile.c_str());
+    if(!in) {
+      ::Error("readInputFileList", "Can't open file list \"%s\"",
+              listFile.c_str());
+      return false;
+    }
+
+    std::string line;
+    while(std::getline(in, line)) {
+      // Strip comments and surrounding white space
+      const std::string::size_type hash = line.find('#');
+      if(hash != std::string::npos) line.erase(hash);
+      const std::string::size_type first = line.find_first_not_of(" \t\r");
+      if(first == std::string::npos) continue;
+      const std::string::size_type last = line.find_last_not_of(" \t\r");
+      if(!expandInputPattern(line.substr(first, last - first + 1), files)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,629 @@
+// System includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/InputFiles.h"
+#include "CPTutorialExample/ToolStage.h"
+
+namespace {
+
+  /// Maximum nesting depth of --options files
+  const unsigned int MAX_OPTIONS_DEPTH = 8;
+
+  /// Split "--name=value" into its parts; "--name" leaves the value empty
+  void splitOption(const std::string& arg, std::string& name,
+                   std::string& value, bool& hasValue)
+  {
+    const std::string::size_type pos = arg.find('=');
+    hasValue = (pos != std::string::npos);
+    name = hasValue ? arg.substr(0, pos) : arg;
+    value = hasValue ? arg.substr(pos + 1) : std::string();
+  }
+
+  /// Fetch the value of an option, either inline or from the next argument
+  bool optionValue(const std::vector<std::string>& args, std::size_t& i,
+                   const std::string& name, bool hasValue, std::string& value)
+  {
+    if(hasValue) return true;
+    if(i + 1 >= args.size()) {
+      ::Error("JobConfig::parse", "Option %s needs a value", name.c_str());
+      return false;
+    }
+    value = args[++i];
+    return true;
+  }
+
+  /// Convert a string to an unsigned integer, rejecting trailing garbage
+  ///
+  /// With allowSuffix a trailing k, M or G multiplies the value by the
+  /// corresponding power of 1024.
+  bool toUnsigned(const std::string& name, const std::string& value,
+                  unsigned long long& result, bool allowSuffix = false)
+  {
+    if(value.empty() || value[0] == '-') {
+      ::Error("JobConfig::parse", "Invalid value for %s: \"%s\"",
+              name.c_str(), value.c_str());
+      return false;
+    }
+    char* end = 0;
+    errno = 0;
+    result = std::strtoull(value.c_str(), &end, 10);
+    if(allowSuffix && *end != '\0' && end[1] == '\0') {
+      unsigned int shift = 0;
+      switch(*end) {
+      case 'k': shift = 10; break;
+      case 'M': shift = 20; break;
+      case 'G': shift = 30; break;
+      default: break;
+      }
+      if(shift > 0) {
+        if(result > (std::numeric_limits<unsigned long long>::max() >>
+                     shift)) {
+          errno = ERANGE;
+        }
+        result <<= shift;
+        ++end;
+      }
+    }
+    if(errno != 0 || *end != '\0') {
+      ::Error("JobConfig::parse", "Invalid value for %s: \"%s\"",
+              name.c_str(), value.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /// Convert a string to an integer type, rejecting values it can't hold
+  template<typename T>
+  bool toUnsigned(const std::string& name, const std::string& value,
+                  T& result, bool allowSuffix = false)
+  {
+    unsigned long long n = 0;
+    if(!toUnsigned(name, value, n, allowSuffix)) return false;
+    if(n > static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
+      ::Error("JobConfig::parse", "Value for %s out of range: \"%s\"",
+              name.c_str(), value.c_str());
+      return false;
+    }
+    result = static_cast<T>(n);
+    return true;
+  }
+
+  /// Split a comma separated list, dropping empty items
+  std::vector<std::string> splitList(const std::string& value)
+  {
+    std::vector<std::string> result;
+    std::string::size_type begin = 0;
+    while(begin <= value.size()) {
+      std::string::size_type end = value.find(',', begin);
+      if(end == std::string::npos) end = value.size();
+      if(end > begin) result.push_back(value.substr(begin, end - begin));
+      begin = end + 1;
+    }
+    return result;
+  }
+
+  /// Strip leading and trailing white space
+  std::string trim(const std::string& str)
+  {
+    const std::string::size_type first = str.find_first_not_of(" \t\r");
+    if(first == std::string::npos) return std::string();
+    const std::string::size_type last = str.find_last_not_of(" \t\r");
+    return str.substr(first, last - first + 1);
+  }
+
+  /// Turn the lines of an options file into command line arguments
+  ///
+  /// Each line holds "name = value" or just "name" for flags, with the
+  /// names of the long command line options minus the leading dashes.
+  bool readOptionsFile(const std::string& fileName,
+                       std::vector<std::string>& args)
+  {
+    std::ifstream in(fileName.c_str());
+    if(!in) {
+      ::Error("JobConfig::parse", "Can't open options file \"%s\"",
+              fileName.c_str());
+      return false;
+    }
+    std::string line;
+    while(std::getline(in, line)) {
+      const std::string::size_type hash = line.find('#');
+      if(hash != std::string::npos) line.erase(hash);
+      const std::string::size_type eq = line.find('=');
+      const std::string name = trim(line.substr(0, eq));
+      if(name.empty()) continue;
+      if(eq == std::string::npos) {
+        args.push_back("--" + name);
+      } else {
+        args.push_back("--" + name + "=" + trim(line.substr(eq + 1)));
+      }
+    }
+    return true;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  const UInt_t JobConfig::MAX_RUN;
+
+  JobConfig::JobConfig()
+    : inputFiles(),
+      prefetch(true),
+      rangeBegin(0),
+      rangeEnd(-1),
+      skipEvents(0),
+      maxEvents(-1),
+      nThreads(1),
+      nProcesses(1),
+      blockSize(1),
+      blockSizeScan(),
+      pipelineThreads(0),
+      readCache(),
+      accessMode(xAOD::TEvent::kClassAccess),
+      compareAccessModes(false),
+      recycleTransients(false),
+      runList(),
+      firstRun(0),
+      lastRun(MAX_RUN),
+      grlFiles(),
+      indexCache(),
+      systematics(),
+      tools(),
+      columnarOutput(),
+      columnarFlushRows(10000),
+      histogramOutput(),
+      skimOutput(),
+      output(),
+      printEvents(false),
+      progressEvery(10000),
+      progressInterval(10),
+      benchmark(false),
+      benchmarkOutput("cp_tutorial_benchmark.json"),
+      memoryReport(false),
+      lazyInit(false),
+      startupReport(false),
+      showHelp(false)
+  {}
+
+  bool JobConfig::parse(int argc, char* argv[])
+  {
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    if(!parseArguments(args, 0)) return false;
+
+    if(inputFiles.empty() && !showHelp) {
+      ::Error("JobConfig::parse", "No file name received!");
+      return false;
+    }
+    if(pipelineThreads > 0 && nThreads > 1) {
+      ::Error("JobConfig::parse", "--pipeline and --threads can't be "
+              "combined");
+      return false;
+    }
+    if(nProcesses > 1 && (pipelineThreads > 0 || nThreads > 1)) {
+      ::Error("JobConfig::parse", "--processes can't be combined with "
+              "--pipeline or --threads");
+      return false;
+    }
+    return true;
+  }
+
+  bool JobConfig::parseArguments(const std::vector<std::string>& args,
+                                 unsigned int depth)
+  {
+    std::string name, value;
+    bool hasValue = false;
+    for(std::size_t i = 0; i < args.size(); ++i) {
+      const std::string& arg = args[i];
+
+      // Positional arguments: input files or glob patterns
+      if(arg.empty() || arg[0] != '-') {
+        if(!expandInputPattern(arg, inputFiles)) return false;
+        continue;
+      }
+
+      splitOption(arg, name, value, hasValue);
+      if(name == "-h" || name == "--help") {
+        showHelp = true;
+      }
+      else if(name == "--options") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        if(depth >= MAX_OPTIONS_DEPTH) {
+          ::Error("JobConfig::parse", "Options files nested too deeply");
+          return false;
+        }
+        std::vector<std::string> fileArgs;
+        if(!readOptionsFile(value, fileArgs) ||
+           !parseArguments(fileArgs, depth + 1)) return false;
+      }
+      else if(name == "--filelist") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !readInputFileList(value, inputFiles)) return false;
+      }
+      else if(name == "--no-prefetch") {
+        prefetch = false;
+      }
+      else if(name == "--skip") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, skipEvents)) return false;
+      }
+      else if(name == "--max-events") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, maxEvents)) return false;
+      }
+      else if(name == "--entry-range") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        const std::string::size_type colon = value.find(':');
+        Long64_t begin = 0, end = 0;
+        if(colon == std::string::npos ||
+           (colon > 0 && !toUnsigned(name, value.substr(0, colon), begin)) ||
+           (colon + 1 < value.size() &&
+            !toUnsigned(name, value.substr(colon + 1), end))) {
+          ::Error("JobConfig::parse", "--entry-range expects \"a:b\", "
+                  "got \"%s\"", value.c_str());
+          return false;
+        }
+        rangeBegin = begin;
+        rangeEnd = (colon + 1 < value.size() ? end : -1);
+        if(rangeEnd >= 0 && rangeEnd < rangeBegin) {
+          ::Error("JobConfig::parse", "Empty entry range: %s", value.c_str());
+          return false;
+        }
+      }
+      else if(name == "--threads") {
+        unsigned int n = 0;
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, n)) return false;
+        if(n == 0) {
+          ::Error("JobConfig::parse", "--threads must be at least 1");
+          return false;
+        }
+        nThreads = n;
+      }
+      else if(name == "--processes") {
+        unsigned int n = 0;
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, n)) return false;
+        if(n == 0) {
+          ::Error("JobConfig::parse", "--processes must be at least 1");
+          return false;
+        }
+        nProcesses = n;
+      }
+      else if(name == "--block-size") {
+        unsigned int n = 0;
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, n)) return false;
+        if(n == 0) {
+          ::Error("JobConfig::parse", "--block-size must be at least 1");
+          return false;
+        }
+        blockSize = n;
+      }
+      else if(name == "--scan-block-sizes") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        const std::vector<std::string> sizes = splitList(value);
+        blockSizeScan.clear();
+        for(std::size_t j = 0; j < sizes.size(); ++j) {
+          unsigned int n = 0;
+          if(!toUnsigned(name, sizes[j], n)) return false;
+          if(n == 0) {
+            ::Error("JobConfig::parse", "Block sizes must be at least 1");
+            return false;
+          }
+          blockSizeScan.push_back(n);
+        }
+      }
+      else if(name == "--pipeline") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, pipelineThreads)) return false;
+      }
+      else if(name == "--cache-size") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, readCache.cacheSize, true)) return false;
+      }
+      else if(name == "--no-cache") {
+        readCache.cacheSize = 0;
+      }
+      else if(name == "--cache-learn-entries") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, readCache.learnEntries)) return false;
+      }
+      else if(name == "--cache-branches") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        readCache.branches = splitList(value);
+      }
+      else if(name == "--access-mode") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        if(value == "class") accessMode = xAOD::TEvent::kClassAccess;
+        else if(value == "branch") accessMode = xAOD::TEvent::kBranchAccess;
+        else if(value == "athena") accessMode = xAOD::TEvent::kAthenaAccess;
+        else {
+          ::Error("JobConfig::parse", "Unknown access mode: %s",
+                  value.c_str());
+          return false;
+        }
+      }
+      else if(name == "--compare-access-modes") {
+        compareAccessModes = true;
+      }
+      else if(name == "--transient-store") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        if(value == "tstore") recycleTransients = false;
+        else if(value == "arena") recycleTransients = true;
+        else {
+          ::Error("JobConfig::parse", "Unknown transient store: %s",
+                  value.c_str());
+          return false;
+        }
+      }
+      else if(name == "--run-list") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        const std::vector<std::string> runs = splitList(value);
+        runList.clear();
+        for(std::size_t j = 0; j < runs.size(); ++j) {
+          UInt_t run = 0;
+          if(!toUnsigned(name, runs[j], run)) return false;
+          runList.push_back(run);
+        }
+      }
+      else if(name == "--run-range") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        const std::string::size_type colon = value.find(':');
+        unsigned long long begin = 0, end = MAX_RUN;
+        if(colon == std::string::npos ||
+           (colon > 0 && !toUnsigned(name, value.substr(0, colon), begin)) ||
+           (colon + 1 < value.size() &&
+            !toUnsigned(name, value.substr(colon + 1), end)) ||
+           end > MAX_RUN || begin > end) {
+          ::Error("JobConfig::parse", "--run-range expects \"first:last\", "
+                  "got \"%s\"", value.c_str());
+          return false;
+        }
+        firstRun = begin;
+        lastRun = end;
+      }
+      else if(name == "--grl") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        const std::vector<std::string> names = splitList(value);
+        grlFiles.insert(grlFiles.end(), names.begin(), names.end());
+      }
+      else if(name == "--index-cache") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        indexCache = value;
+      }
+      else if(name == "--systematics") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        systematics.clear();
+        if(value != "none") systematics = splitList(value);
+      }
+      else if(name == "--tool-config") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !ToolConfig::readFile(value, tools)) return false;
+      }
+      else if(name == "--columnar-output") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        columnarOutput = value;
+      }
+      else if(name == "--columnar-flush") {
+        Long64_t n = 0;
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, n)) return false;
+        columnarFlushRows = std::max<Long64_t>(1, n);
+      }
+      else if(name == "--histogram-output") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        histogramOutput = value;
+      }
+      else if(name == "--skim-output") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        skimOutput = value;
+      }
+      else if(name == "--compression") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !parseCompression(value, output.compression)) return false;
+      }
+      else if(name == "--basket-size") {
+        unsigned long long n = 0;
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, n, true)) return false;
+        if(n > 0x40000000ull) {
+          ::Error("JobConfig::parse", "--basket-size must be at most 1G");
+          return false;
+        }
+        output.basketSize = n;
+      }
+      else if(name == "--compression-threads") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, output.compressionThreads)) return false;
+      }
+      else if(name == "--print-events") {
+        printEvents = true;
+      }
+      else if(name == "--progress-every") {
+        if(!optionValue(args, i, name, hasValue, value) ||
+           !toUnsigned(name, value, progressEvery)) return false;
+      }
+      else if(name == "--progress-interval") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        char* end = 0;
+        progressInterval = std::strtod(value.c_str(), &end);
+        if(value.empty() || *end != '\0' || progressInterval < 0) {
+          ::Error("JobConfig::parse", "Invalid value for %s: \"%s\"",
+                  name.c_str(), value.c_str());
+          return false;
+        }
+      }
+      else if(name == "--benchmark") {
+        benchmark = true;
+      }
+      else if(name == "--memory-report") {
+        memoryReport = true;
+      }
+      else if(name == "--lazy-init") {
+        lazyInit = true;
+      }
+      else if(name == "--startup-report") {
+        startupReport = true;
+      }
+      else if(name == "--benchmark-output") {
+        if(!optionValue(args, i, name, hasValue, value)) return false;
+        benchmark = true;
+        benchmarkOutput = value;
+      }
+      else {
+        ::Error("JobConfig::parse", "Unknown option: %s", arg.c_str());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void JobConfig::printUsage(const char* appName)
+  {
+    ::Info(appName, "Usage: %s [options] [xAOD file names or patterns]",
+           appName);
+    ::Info(appName, "Options:");
+    ::Info(appName, "  --options FILE   read \"name = value\" options from "
+           "FILE");
+    ::Info(appName, "  --filelist FILE  read input file names from FILE");
+    ::Info(appName, "  --no-prefetch    don't open the next file in the "
+           "background");
+    ::Info(appName, "  --entry-range A:B process the entries [A, B), counted "
+           "across all files; A or B may be left out");
+    ::Info(appName, "  --skip N         skip the first N entries of the range");
+    ::Info(appName, "  --max-events N   process at most N entries");
+    ::Info(appName, "  --threads N      process the files with N worker "
+           "threads");
+    ::Info(appName, "  --processes N    fork N processes after the CP tool "
+           "setup, each processing a slice");
+    ::Info(appName, "                   of the entries, and merge their "
+           "outputs");
+    ::Info(appName, "  --block-size K   process the entries in blocks of K "
+           "(default: 1)");
+    ::Info(appName, "  --scan-block-sizes K1,K2,...");
+    ::Info(appName, "                   run the job with every block size "
+           "and report the fastest");
+    ::Info(appName, "  --pipeline N     decompress the input on N threads "
+           "ahead of the event loop");
+    ::Info(appName, "  --cache-size BYTES (k/M/G suffix allowed)");
+    ::Info(appName, "                   size of the TTreeCache of the input");
+    ::Info(appName, "  --no-cache       disable the TTreeCache");
+    ::Info(appName, "  --cache-learn-entries N");
+    ::Info(appName, "                   entries of the cache learning phase, "
+           "0 caches only the registered branches");
+    ::Info(appName, "  --cache-branches A,B,...");
+    ::Info(appName, "                   containers to register in the cache "
+           "(default: EventInfo)");
+    ::Info(appName, "  --access-mode class|branch|athena");
+    ::Info(appName, "                   auxiliary store access mode of "
+           "TEvent (default: class)");
+    ::Info(appName, "  --compare-access-modes");
+    ::Info(appName, "                   run the job in every access mode "
+           "and compare the speed and memory use");
+    ::Info(appName, "  --transient-store tstore|arena");
+    ::Info(appName, "                   keep transient objects in a "
+           "RecyclingStore, reusing them across events (default: "
+           "tstore)");
+    ::Info(appName, "  --run-list R1,R2,...");
+    ::Info(appName, "                   only process these runs, cut on "
+           "EventInfo before anything else is read");
+    ::Info(appName, "  --run-range FIRST:LAST");
+    ::Info(appName, "                   only process runs in this range "
+           "(both included)");
+    ::Info(appName, "  --grl FILE,...   good-run list XML files applied to "
+           "data in the preselection");
+    ::Info(appName, "  --index-cache DIR");
+    ::Info(appName, "                   keep the entries passing the "
+           "preselection in DIR, and only read those next time");
+    ::Info(appName, "  --systematics none|all|A,B,...");
+    ::Info(appName, "                   systematic variations run in the "
+           "same pass over each event (default: none)");
+    ::Info(appName, "  --tool-config FILE");
+    ::Info(appName, "                   JSON file of the tool stages to run, "
+           "in order");
+    const std::vector<std::string> types = ToolStageFactory::types();
+    std::string typeList;
+    for(std::size_t i = 0; i < types.size(); ++i) {
+      typeList += (i ? ", " : "") + types[i];
+    }
+    ::Info(appName, "                   (types: %s)", typeList.c_str());
+    ::Info(appName, "  --columnar-output FILE");
+    ::Info(appName, "                   write the selected variables to a "
+           "flat tree in FILE");
+    ::Info(appName, "  --columnar-flush N");
+    ::Info(appName, "                   rows buffered per worker before "
+           "writing (default: 10000)");
+    ::Info(appName, "  --histogram-output FILE");
+    ::Info(appName, "                   fill the job's histograms and write "
+           "them to FILE");
+    ::Info(appName, "  --skim-output FILE");
+    ::Info(appName, "                   copy the events passing the "
+           "preselection, unmodified, to FILE");
+    ::Info(appName, "  --compression ALGORITHM[:LEVEL]|SETTING");
+    ::Info(appName, "                   compression of the output files, "
+           "with zlib, lzma, lz4 or zstd");
+    ::Info(appName, "                   (default: ROOT's)");
+    ::Info(appName, "  --basket-size BYTES (k/M/G suffix allowed)");
+    ::Info(appName, "                   basket size of the output branches "
+           "(default: ROOT's)");
+    ::Info(appName, "  --compression-threads N");
+    ::Info(appName, "                   compress the output baskets on N "
+           "threads (default: 0)");
+    ::Info(appName, "  --print-events   print a message for every event");
+    ::Info(appName, "  --progress-every N");
+    ::Info(appName, "                   report the progress every N events "
+           "(default: 10000, 0: never)");
+    ::Info(appName, "  --progress-interval SECONDS");
+    ::Info(appName, "                   report the progress at least this "
+           "often (default: 10, 0: never)");
+    ::Info(appName, "  --benchmark      time the phases of every event");
+    ::Info(appName, "  --benchmark-output FILE");
+    ::Info(appName, "                   JSON file of the benchmark report "
+           "(default: cp_tutorial_benchmark.json)");
+    ::Info(appName, "  --memory-report  report the RSS and the allocations "
+           "with the progress, and the memory");
+    ::Info(appName, "                   use of every container at the end "
+           "of the job");
+    ::Info(appName, "  --lazy-init      set up the CP tools when the first "
+           "event passes the preselection");
+    ::Info(appName, "  --startup-report report the time taken by each step "
+           "before the first event");
+    ::Info(appName, "  -h, --help       print this message");
+  }
+
+  Long64_t JobConfig::firstEntry() const
+  {
+    return rangeBegin + skipEvents;
+  }
+
+  Long64_t JobConfig::lastEntry() const
+  {
+    const Long64_t first = firstEntry();
+    Long64_t last = rangeEnd;
+    if(maxEvents >= 0 && (last < 0 || first + maxEvents < last)) {
+      last = first + maxEvents;
+    }
+    return (last >= 0 ? std::max(first, last) : last);
+  }
+
+  const char* JobConfig::accessModeName(xAOD::TEvent::EAuxMode mode)
+  {
+    switch(mode) {
+    case xAOD::TEvent::kClassAccess: return "class";
+    case xAOD::TEvent::kBranchAccess: return "branch";
+    case xAOD::TEvent::kAthenaAccess: return "athena";
+    default: return "unknown";
+    }
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,325 @@
+// System includes
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/JsonValue.h"
+
+namespace {
+
+  /// Maximum nesting depth of arrays and objects
+  const unsigned int MAX_DEPTH = 64;
+
+  /// Whether a character is a decimal digit
+  bool isDigit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  /// Value of a hexadecimal digit, -1 for other characters
+  int hexDigit(char c)
+  {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  /// Append a code point to a string, UTF-8 encoded
+  void appendUtf8(std::string& out, unsigned long c)
+  {
+    if(c < 0x80) {
+      out += char(c);
+    } else if(c < 0x800) {
+      out += char(0xc0 | (c >> 6));
+      out += char(0x80 | (c & 0x3f));
+    } else {
+      out += char(0xe0 | (c >> 12));
+      out += char(0x80 | ((c >> 6) & 0x3f));
+      out += char(0x80 | (c & 0x3f));
+    }
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  /// Recursive-descent parser filling JsonValue objects
+  class JsonParser {
+
+  public:
+    JsonParser(const std::string& text)
+      : m_text(text), m_pos(0), m_error()
+    {}
+
+    /// Parse the whole text as one value
+    bool parseDocument(JsonValue& result)
+    {
+      if(!parseValue(result, 0)) return false;
+      skipSpace();
+      if(m_pos != m_text.size()) return fail("trailing characters");
+      return true;
+    }
+
+    /// Message of the first problem found
+    const std::string& error() const { return m_error; }
+
+  private:
+    /// Record a problem, with the line it is on
+    bool fail(const std::string& what)
+    {
+      std::size_t line = 1;
+      for(std::size_t i = 0; i < m_pos && i < m_text.size(); ++i) {
+        if(m_text[i] == '\n') ++line;
+      }
+      std::ostringstream message;
+      message << what << " on line " << line;
+      m_error = message.str();
+      return false;
+    }
+
+    void skipSpace()
+    {
+      while(m_pos < m_text.size() &&
+            (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' ||
+             m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) ++m_pos;
+    }
+
+    /// Consume a literal word, e.g. "true"
+    bool literal(const char* word)
+    {
+      const std::string w(word);
+      if(m_text.compare(m_pos, w.size(), w) != 0) return false;
+      m_pos += w.size();
+      return true;
+    }
+
+    bool parseValue(JsonValue& result, unsigned int depth)
+    {
+      skipSpace();
+      if(m_pos >= m_text.size()) return fail("unexpected end of input");
+      const char c = m_text[m_pos];
+      if(c == '{' || c == '[') {
+        if(depth >= MAX_DEPTH) return fail("nesting too deep");
+        return c == '{' ? parseObject(result, depth) :
+          parseArray(result, depth);
+      }
+      if(c == '"') {
+        result.m_type = JsonValue::kString;
+        return parseString(result.m_string);
+      }
+      if(literal("true") || literal("false")) {
+        result.m_type = JsonValue::kBool;
+        result.m_bool = (c == 't');
+        return true;
+      }
+      if(literal("null")) {
+        result.m_type = JsonValue::kNull;
+        return true;
+      }
+      return parseNumber(result);
+    }
+
+    bool parseNumber(JsonValue& result)
+    {
+      // Check the JSON grammar first, strtod() would also take e.g. hex
+      // numbers, "nan" and "inf"
+      const std::size_t begin = m_pos;
+      std::size_t end = m_pos;
+      if(end < m_text.size() && m_text[end] == '-') ++end;
+      if(end < m_text.size() && m_text[end] == '0') {
+        ++end;
+      } else if(end < m_text.size() && isDigit(m_text[end])) {
+        while(end < m_text.size() && isDigit(m_text[end])) ++end;
+      } else {
+        return fail("invalid value");
+      }
+      if(end < m_text.size() && m_text[end] == '.') {
+        ++end;
+        if(end >= m_text.size() || !isDigit(m_text[end])) {
+          return fail("invalid number");
+        }
+        while(end < m_text.size() && isDigit(m_text[end])) ++end;
+      }
+      if(end < m_text.size() && (m_text[end] == 'e' || m_text[end] == 'E')) {
+        ++end;
+        if(end < m_text.size() && (m_text[end] == '+' || m_text[end] == '-')) {
+          ++end;
+        }
+        if(end >= m_text.size() || !isDigit(m_text[end])) {
+          return fail("invalid number");
+        }
+        while(end < m_text.size() && isDigit(m_text[end])) ++end;
+      }
+
+      const std::string number = m_text.substr(begin, end - begin);
+      const double value = std::strtod(number.c_str(), 0);
+      if(std::isinf(value)) return fail("number out of range");
+      m_pos = end;
+      result.m_type = JsonValue::kNumber;
+      result.m_number = value;
+      return true;
+    }
+
+    bool parseString(std::string& out)
+    {
+      ++m_pos;
+      out.clear();
+      while(m_pos < m_text.size()) {
+        const char c = m_text[m_pos++];
+        if(c == '"') return true;
+        if(c != '\\') {
+          out += c;
+          continue;
+        }
+        if(m_pos >= m_text.size()) break;
+        const char e = m_text[m_pos++];
+        switch(e) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+          if(m_pos + 4 > m_text.size()) return fail("invalid \\u escape");
+          unsigned long code = 0;
+          for(std::size_t i = 0; i < 4; ++i) {
+            const int digit = hexDigit(m_text[m_pos + i]);
+            if(digit < 0) return fail("invalid \\u escape");
+            code = 16 * code + digit;
+          }
+          appendUtf8(out, code);
+          m_pos += 4;
+          break;
+        }
+        default: return fail("invalid escape in string");
+        }
+      }
+      return fail("unterminated string");
+    }
+
+    bool parseArray(JsonValue& result, unsigned int depth)
+    {
+      ++m_pos;
+      result.m_type = JsonValue::kArray;
+      skipSpace();
+      if(m_pos < m_text.size() && m_text[m_pos] == ']') {
+        ++m_pos;
+        return true;
+      }
+      while(true) {
+        result.m_array.push_back(JsonValue());
+        if(!parseValue(result.m_array.back(), depth + 1)) return false;
+        skipSpace();
+        if(m_pos >= m_text.size()) return fail("unterminated array");
+        const char c = m_text[m_pos++];
+        if(c == ']') return true;
+        if(c != ',') return fail("expected ',' or ']'");
+      }
+    }
+
+    bool parseObject(JsonValue& result, unsigned int depth)
+    {
+      ++m_pos;
+      result.m_type = JsonValue::kObject;
+      skipSpace();
+      if(m_pos < m_text.size() && m_text[m_pos] == '}') {
+        ++m_pos;
+        return true;
+      }
+      std::string key;
+      while(true) {
+        skipSpace();
+        if(m_pos >= m_text.size() || m_text[m_pos] != '"') {
+          return fail("expected a member name");
+        }
+        if(!parseString(key)) return false;
+        skipSpace();
+        if(m_pos >= m_text.size() || m_text[m_pos] != ':') {
+          return fail("expected ':'");
+        }
+        ++m_pos;
+        if(result.m_object.count(key)) {
+          return fail("duplicate member \"" + key + "\"");
+        }
+        if(!parseValue(result.m_object[key], depth + 1)) return false;
+        skipSpace();
+        if(m_pos >= m_text.size()) return fail("unterminated object");
+        const char c = m_text[m_pos++];
+        if(c == '}') return true;
+        if(c != ',') return fail("expected ',' or '}'");
+      }
+    }
+
+    const std::string& m_text;
+    std::size_t m_pos;
+    std::string m_error;
+
+  }; // class JsonParser
+
+  JsonValue::JsonValue()
+    : m_type(kNull),
+      m_bool(false),
+      m_number(0),
+      m_string(),
+      m_array(),
+      m_object()
+  {}
+
+  bool JsonValue::parse(const std::string& text, JsonValue& result,
+                        std::string& error)
+  {
+    result = JsonValue();
+    JsonParser parser(text);
+    if(parser.parseDocument(result)) return true;
+    error = parser.error();
+    return false;
+  }
+
+  bool JsonValue::readFile(const std::string& fileName, JsonValue& result)
+  {
+    std::ifstream in(fileName.c_str());
+    if(!in) {
+      ::Error("JsonValue", "Can't open JSON file \"%s\"", fileName.c_str());
+      return false;
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    std::string error;
+    if(!parse(text.str(), result, error)) {
+      ::Error("JsonValue", "Invalid JSON in \"%s\": %s", fileName.c_str(),
+              error.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  const char* JsonValue::typeName(Type type)
+  {
+    switch(type) {
+    case kNull: return "null";
+    case kBool: return "boolean";
+    case kNumber: return "number";
+    case kString: return "string";
+    case kArray: return "array";
+    case kObject: return "object";
+    default: return "unknown";
+    }
+  }
+
+  const JsonValue* JsonValue::member(const std::string& key) const
+  {
+    if(m_type != kObject) return 0;
+    std::map<std::string, JsonValue>::const_iterator itr = m_object.find(key);
+    return itr == m_object.end() ? 0 : &itr->second;
+  }
+
+} // namespace CPTutorial
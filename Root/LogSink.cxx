@@ -0,0 +1,65 @@
+// Local includes
+#include "CPTutorialExample/LogSink.h"
+
+namespace CPTutorial {
+
+  AsyncLogSink::AsyncLogSink(FILE* out)
+    : m_out(out),
+      m_buffer(),
+      m_mutex(),
+      m_ready(),
+      m_stop(false),
+      m_thread()
+  {
+    // Start the thread only once all members are set up
+    m_thread = std::thread(&AsyncLogSink::run, this);
+  }
+
+  AsyncLogSink::~AsyncLogSink()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_ready.notify_one();
+    m_thread.join();
+  }
+
+  void AsyncLogSink::write(const std::string& line)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_buffer.push_back(line);
+    }
+    m_ready.notify_one();
+  }
+
+  void AsyncLogSink::info(const char* location, const std::string& message)
+  {
+    write(std::string("Info in <") + location + ">: " + message);
+  }
+
+  void AsyncLogSink::run()
+  {
+    std::vector<std::string> lines;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true) {
+      m_ready.wait(lock, [this]() { return m_stop || !m_buffer.empty(); });
+      lines.swap(m_buffer);
+      const bool stop = m_stop;
+
+      // Write without holding the lock, so writers never wait for I/O
+      lock.unlock();
+      for(std::size_t i = 0; i < lines.size(); ++i) {
+        std::fputs(lines[i].c_str(), m_out);
+        std::fputc('\n', m_out);
+      }
+      std::fflush(m_out);
+      lines.clear();
+      lock.lock();
+
+      if(stop && m_buffer.empty()) break;
+    }
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,265 @@
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// ROOT includes
+#include "TTree.h"
+#include "TBranch.h"
+#include "TObjArray.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/MemoryAccounting.h"
+#include "CPTutorialExample/ProcessMemory.h"
+#include "CPTutorialExample/ResultStream.h"
+#include "CPTutorialExample/Check.h"
+
+namespace {
+
+  /// Allocations of the current thread. Plain integers, so that they
+  /// need no construction or destruction, even during the start-up and
+  /// tear-down of a thread.
+  thread_local ULong64_t t_nAllocations = 0;
+  thread_local ULong64_t t_bytes = 0;
+  /// Whether the allocations are counted. Constant-initialised, so it
+  /// can be read by allocations made during static initialisation.
+  std::atomic<bool> s_counting(false);
+
+  /// Allocate memory the way the default operator new does
+  void* allocate(std::size_t size)
+  {
+    if(CPT_UNLIKELY(s_counting.load(std::memory_order_relaxed))) {
+      ++t_nAllocations;
+      t_bytes += size;
+    }
+    if(size == 0) size = 1;
+    while(true) {
+      void* ptr = std::malloc(size);
+      if(ptr) return ptr;
+      std::new_handler handler = std::set_new_handler(0);
+      std::set_new_handler(handler);
+      if(!handler) throw std::bad_alloc();
+      handler();
+    }
+  }
+
+  /// Key of the container an event tree branch belongs to
+  std::string containerName(const std::string& branch)
+  {
+    const std::string::size_type dyn = branch.find("AuxDyn.");
+    if(dyn != std::string::npos) return branch.substr(0, dyn);
+    const std::string::size_type aux = branch.rfind("Aux.");
+    if(aux != std::string::npos && aux + 4 == branch.size()) {
+      return branch.substr(0, aux);
+    }
+    return branch;
+  }
+
+  /// Whether a container uses more memory per event than another
+  struct LargerContainer {
+    LargerContainer(Long64_t inputEvents, Long64_t nEvents)
+      : m_inputEvents(std::max(1ll, inputEvents)),
+        m_nEvents(std::max(1ll, nEvents))
+    {}
+    double perEvent(const CPTutorial::MemoryAccount::Container& c) const
+    {
+      return c.inputBytes / m_inputEvents +
+        double(c.transient.bytes) / m_nEvents;
+    }
+    bool operator()(const CPTutorial::MemoryAccount::Container* a,
+                    const CPTutorial::MemoryAccount::Container* b) const
+    {
+      return perEvent(*a) > perEvent(*b);
+    }
+    Long64_t m_inputEvents, m_nEvents;
+  };
+
+} // private namespace
+
+// The replacement allocation functions, counting every allocation of
+// the job
+void* operator new(std::size_t size)
+{
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  try { return allocate(size); }
+  catch(...) { return 0; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  try { return allocate(size); }
+  catch(...) { return 0; }
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+namespace CPTutorial {
+
+  AllocationCount threadAllocations()
+  {
+    AllocationCount result;
+    result.nAllocations = t_nAllocations;
+    result.bytes = t_bytes;
+    return result;
+  }
+
+  void enableAllocationCounting()
+  {
+    s_counting.store(true, std::memory_order_relaxed);
+  }
+
+  bool allocationCountingActive()
+  {
+    const AllocationCount before = threadAllocations();
+    char* volatile probe = new char;
+    delete probe;
+    return (threadAllocations() - before).nAllocations > 0;
+  }
+
+  MemoryAccount::Container::Container()
+    : name(),
+      inputBytes(0),
+      transient()
+  {}
+
+  MemoryAccount::MemoryAccount()
+    : m_containers(),
+      m_inputEvents(0)
+  {}
+
+  std::size_t MemoryAccount::container(const std::string& name)
+  {
+    for(std::size_t i = 0; i < m_containers.size(); ++i) {
+      if(m_containers[i].name == name) return i;
+    }
+    m_containers.push_back(Container());
+    m_containers.back().name = name;
+    return m_containers.size() - 1;
+  }
+
+  void MemoryAccount::addInput(const TTree& tree, Long64_t nEvents)
+  {
+    if(nEvents <= 0) return;
+    m_inputEvents += nEvents;
+    TObjArray* branches = const_cast<TTree&>(tree).GetListOfBranches();
+    for(Int_t i = 0; branches && i <= branches->GetLast(); ++i) {
+      const TBranch* branch = dynamic_cast<const TBranch*>(branches->At(i));
+      if(!branch || branch->GetEntries() <= 0) continue;
+      // TEvent only reads the branches that are asked for, the others
+      // take no memory
+      if(branch->GetReadEntry() < 0) continue;
+      Container& c =
+        m_containers[container(containerName(branch->GetName()))];
+      c.inputBytes +=
+        double(branch->GetTotBytes("*")) / branch->GetEntries() * nEvents;
+    }
+  }
+
+  MemoryAccount& MemoryAccount::operator+=(const MemoryAccount& rhs)
+  {
+    for(std::size_t i = 0; i < rhs.m_containers.size(); ++i) {
+      const Container& in = rhs.m_containers[i];
+      Container& out = m_containers[container(in.name)];
+      out.inputBytes += in.inputBytes;
+      out.transient += in.transient;
+    }
+    m_inputEvents += rhs.m_inputEvents;
+    return *this;
+  }
+
+  void MemoryAccount::write(ResultWriter& out) const
+  {
+    out.put<unsigned long long>(m_containers.size());
+    for(std::size_t i = 0; i < m_containers.size(); ++i) {
+      out.put(m_containers[i].name);
+      out.put(m_containers[i].inputBytes);
+      out.put(m_containers[i].transient);
+    }
+    out.put(m_inputEvents);
+  }
+
+  bool MemoryAccount::read(ResultReader& in)
+  {
+    unsigned long long size = 0;
+    if(!in.get(size)) return false;
+    m_containers.clear();
+    for(unsigned long long i = 0; i < size; ++i) {
+      Container c;
+      if(!in.get(c.name) || !in.get(c.inputBytes) || !in.get(c.transient)) {
+        return false;
+      }
+      m_containers.push_back(c);
+    }
+    return in.get(m_inputEvents);
+  }
+
+  void MemoryAccount::print(const char* location, Long64_t nEvents) const
+  {
+    std::vector<const Container*> sorted;
+    for(std::size_t i = 0; i < m_containers.size(); ++i) {
+      sorted.push_back(&m_containers[i]);
+    }
+    const LargerContainer larger(m_inputEvents, nEvents);
+    std::stable_sort(sorted.begin(), sorted.end(), larger);
+
+    const double inputEvents = std::max(1ll, m_inputEvents);
+    const double events = std::max(1ll, nEvents);
+    Info(location, "%-40s %12s %12s %12s", "Container [kB/event]",
+         "input", "transient", "allocations");
+    for(std::size_t i = 0; i < sorted.size(); ++i) {
+      const Container& c = *sorted[i];
+      Info(location, "%-40s %12.2f %12.2f %12.1f", c.name.c_str(),
+           c.inputBytes / inputEvents / 1024.,
+           c.transient.bytes / events / 1024.,
+           c.transient.nAllocations / events);
+    }
+  }
+
+  MemoryMonitor::MemoryMonitor()
+    : m_bytes(0),
+      m_events(0)
+  {}
+
+  std::string MemoryMonitor::status() const
+  {
+    const Long64_t events = m_events.load(std::memory_order_relaxed);
+    const ULong64_t bytes = m_bytes.load(std::memory_order_relaxed);
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer),
+                  "RSS %.0f MB (peak %.0f MB), %.1f kB allocated/event",
+                  residentMemory(), peakResidentMemory(),
+                  events > 0 ? bytes / 1024. / events : 0.);
+    return buffer;
+  }
+
+} // namespace CPTutorial
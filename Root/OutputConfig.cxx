@@ -0,0 +1,103 @@
+// System includes
+#include <cerrno>
+#include <cstdlib>
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TObjArray.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/OutputConfig.h"
+
+namespace {
+
+  /// A compression algorithm, by its ROOT code. The codes are spelled out
+  /// rather than taken from Compression.h, whose names changed between
+  /// ROOT versions; LZ4 needs ROOT 6.12 and ZSTD ROOT 6.20.
+  struct Algorithm {
+    const char* name;
+    Int_t code;
+    /// Level of ROOT's preset using the algorithm
+    Int_t defaultLevel;
+  };
+  const Algorithm ALGORITHMS[] = {
+    { "zlib", 1, 1 },
+    { "lzma", 2, 8 },
+    { "lz4", 4, 4 },
+    { "zstd", 5, 5 }
+  };
+
+  /// Convert a string to a small non-negative number
+  bool toLevel(const std::string& value, Int_t& result)
+  {
+    if(value.empty() || value[0] < '0' || value[0] > '9') return false;
+    char* end = 0;
+    errno = 0;
+    const long n = std::strtol(value.c_str(), &end, 10);
+    if(errno != 0 || *end != '\0' || n > 9999) return false;
+    result = n;
+    return true;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  OutputConfig::OutputConfig()
+    : compression(-1),
+      basketSize(0),
+      compressionThreads(0)
+  {}
+
+  bool parseCompression(const std::string& value, Int_t& setting)
+  {
+    // ROOT's numeric setting
+    Int_t number = 0;
+    if(toLevel(value, number)) {
+      setting = number;
+      return true;
+    }
+
+    const std::string::size_type colon = value.find(':');
+    const std::string name = value.substr(0, colon);
+    for(std::size_t i = 0; i < sizeof(ALGORITHMS) / sizeof(Algorithm); ++i) {
+      const Algorithm& algo = ALGORITHMS[i];
+      if(name != algo.name) continue;
+      Int_t level = algo.defaultLevel;
+      if(colon != std::string::npos &&
+         (!toLevel(value.substr(colon + 1), level) || level > 9)) {
+        break;
+      }
+      setting = 100 * algo.code + level;
+      return true;
+    }
+    ::Error("parseCompression", "Invalid compression setting: \"%s\"",
+            value.c_str());
+    return false;
+  }
+
+  void configureOutputFile(TFile& file, const OutputConfig& config)
+  {
+    if(config.compression >= 0) {
+      file.SetCompressionSettings(config.compression);
+    }
+  }
+
+  void configureOutputTree(TTree& tree, const OutputConfig& config)
+  {
+    if(config.basketSize > 0) tree.SetBasketSize("*", config.basketSize);
+
+    // Branches take the compression of the file when they are created;
+    // those of a cloned tree keep the one of their input instead
+    if(config.compression < 0) return;
+    TObjArray* branches = tree.GetListOfBranches();
+    for(Int_t i = 0; branches && i <= branches->GetLast(); ++i) {
+      TBranch* branch = dynamic_cast<TBranch*>(branches->At(i));
+      if(branch) branch->SetCompressionSettings(config.compression);
+    }
+  }
+
+} // namespace CPTutorial
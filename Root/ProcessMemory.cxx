@@ -0,0 +1,47 @@
+// System includes
+#include <sys/resource.h>
+
+// ROOT includes
+#include "TSystem.h"
+
+// Local includes
+#include "CPTutorialExample/ProcessMemory.h"
+
+namespace {
+
+  /// The ru_maxrss of getrusage() [MB]
+  double maxResidentMemory(int who)
+  {
+    struct rusage usage;
+    if(::getrusage(who, &usage) != 0) return 0;
+#ifdef __APPLE__
+    // Reported in bytes on OS X...
+    return usage.ru_maxrss / 1024. / 1024.;
+#else
+    // ...and in kilobytes on Linux
+    return usage.ru_maxrss / 1024.;
+#endif
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  double residentMemory()
+  {
+    ProcInfo_t info;
+    if(gSystem->GetProcInfo(&info) != 0) return 0;
+    return info.fMemResident / 1024.;
+  }
+
+  double peakResidentMemory()
+  {
+    return maxResidentMemory(RUSAGE_SELF);
+  }
+
+  double childrenPeakResidentMemory()
+  {
+    return maxResidentMemory(RUSAGE_CHILDREN);
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,91 @@
+// System includes
+#include <algorithm>
+#include <cstdio>
+
+// Local includes
+#include "CPTutorialExample/ProgressReporter.h"
+#include "CPTutorialExample/LogSink.h"
+#include "CPTutorialExample/MemoryAccounting.h"
+
+namespace {
+
+  /// Events between two looks at the clock
+  const Long64_t CLOCK_STRIDE = 256;
+  /// Event count standing for "never"
+  const Long64_t NEVER = Long64_t(1) << 62;
+
+} // private namespace
+
+namespace CPTutorial {
+
+  ProgressReporter::ProgressReporter(AsyncLogSink& sink, Long64_t everyEvents,
+                                     double everySeconds)
+    : m_sink(sink),
+      m_everyEvents(everyEvents),
+      m_everySeconds(everySeconds),
+      m_expected(-1),
+      m_memory(0),
+      m_done(0),
+      m_nextCheck(0),
+      m_mutex(),
+      m_start(clock::now()),
+      m_lastReport(m_start),
+      m_nextReport(everyEvents > 0 ? everyEvents : -1)
+  {
+    m_nextCheck = nextCheck(0);
+  }
+
+  void ProgressReporter::check(Long64_t done)
+  {
+    // Only one thread does the bookkeeping; the others just carry on
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+    if(!lock.owns_lock()) return;
+    if(done < m_nextCheck.load(std::memory_order_relaxed)) return;
+
+    const clock::time_point now = clock::now();
+    const bool byCount = (m_nextReport > 0 && done >= m_nextReport);
+    const bool byTime = (m_everySeconds > 0 &&
+                         std::chrono::duration<double>(
+                           now - m_lastReport).count() >= m_everySeconds);
+    if(byCount || byTime) {
+      const double elapsed =
+        std::chrono::duration<double>(now - m_start).count();
+      const double rate = (elapsed > 0 ? done / elapsed : 0.);
+      char message[256];
+      const Long64_t expected = m_expected.load();
+      if(expected > 0 && rate > 0) {
+        const double eta = std::max(0., (expected - done) / rate);
+        std::snprintf(message, sizeof(message),
+                      "Processed %lli/%lli events (%.1f%%), %.1f events/s, "
+                      "ETA %.0f s", done, expected, 100. * done / expected,
+                      rate, eta);
+      } else {
+        std::snprintf(message, sizeof(message),
+                      "Processed %lli events, %.1f events/s", done, rate);
+      }
+      if(m_memory) {
+        m_sink.info("EventLoop", std::string(message) + ", " +
+                    m_memory->status());
+      } else {
+        m_sink.info("EventLoop", message);
+      }
+      m_lastReport = now;
+      if(m_everyEvents > 0) {
+        while(m_nextReport <= done) m_nextReport += m_everyEvents;
+      }
+    }
+
+    m_nextCheck.store(nextCheck(done), std::memory_order_relaxed);
+  }
+
+  Long64_t ProgressReporter::nextCheck(Long64_t done) const
+  {
+    // With no time limit, only the event count needs to be watched
+    Long64_t next = (m_everySeconds > 0 ? done + CLOCK_STRIDE : -1);
+    if(m_nextReport > 0 && (next < 0 || m_nextReport < next)) {
+      next = m_nextReport;
+    }
+    return (next > 0 ? next : NEVER);
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,102 @@
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+#include "TTreeCacheUnzip.h"
+#include "TObjArray.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/ReadCache.h"
+
+namespace CPTutorial {
+
+  ReadCacheConfig::ReadCacheConfig()
+    : cacheSize(-1),
+      learnEntries(-1),
+      branches(1, "EventInfo")
+  {}
+
+  ReadStats::ReadStats()
+    : nFiles(0),
+      bytesRead(0),
+      readCalls(0),
+      cacheBytesRead(0),
+      noCacheBytesRead(0)
+  {}
+
+  ReadStats& ReadStats::operator+=(const ReadStats& rhs)
+  {
+    nFiles += rhs.nFiles;
+    bytesRead += rhs.bytesRead;
+    readCalls += rhs.readCalls;
+    cacheBytesRead += rhs.cacheBytesRead;
+    noCacheBytesRead += rhs.noCacheBytesRead;
+    return *this;
+  }
+
+  void ReadStats::addFile(const TFile& file, const TTree* tree)
+  {
+    ++nFiles;
+    bytesRead += file.GetBytesRead();
+    readCalls += file.GetReadCalls();
+    const TTreeCache* cache =
+      dynamic_cast<const TTreeCache*>(file.GetCacheRead(tree));
+    if(cache) {
+      cacheBytesRead += cache->GetBytesRead();
+      noCacheBytesRead += cache->GetNoCacheBytesRead();
+    }
+  }
+
+  double ReadStats::cacheHitRatio() const
+  {
+    const Long64_t total = cacheBytesRead + noCacheBytesRead;
+    return total > 0 ? double(cacheBytesRead) / total : 0.;
+  }
+
+  void configureReadCache(TTree& tree, const ReadCacheConfig& config)
+  {
+    if(config.cacheSize == 0) {
+      tree.SetCacheSize(0);
+      return;
+    }
+    if(config.cacheSize > 0) tree.SetCacheSize(config.cacheSize);
+    if(tree.GetCacheSize() <= 0) return;
+
+    // Register the branches we know will be read. TTreeCache complains
+    // about names it can't find, so only existing branches are added.
+    TObjArray* branches = tree.GetListOfBranches();
+    for(std::size_t i = 0; i < config.branches.size(); ++i) {
+      const std::string& key = config.branches[i];
+      const std::string aux = key + "Aux.";
+      const std::string dyn = key + "AuxDyn.";
+      for(Int_t j = 0; branches && j <= branches->GetLast(); ++j) {
+        const TObject* branch = branches->At(j);
+        if(!branch) continue;
+        const std::string name = branch->GetName();
+        if(name == key || name == aux ||
+           name.compare(0, dyn.size(), dyn) == 0) {
+          tree.AddBranchToCache(name.c_str(), kTRUE);
+        }
+      }
+    }
+
+    // Without a learning phase the cache holds only what we registered
+    if(config.learnEntries == 0) tree.StopCacheLearningPhase();
+  }
+
+  void setCacheLearnEntries(const ReadCacheConfig& config)
+  {
+    // Read by every TTreeCache when it is created, so it can't be set
+    // per tree once TEvent has made the cache
+    if(config.learnEntries > 0) {
+      TTreeCache::SetLearnEntries(config.learnEntries);
+    }
+  }
+
+  void enableParallelUnzip()
+  {
+    TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+  }
+
+} // namespace CPTutorial
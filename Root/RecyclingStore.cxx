@@ -0,0 +1,136 @@
+// System includes
+#include <algorithm>
+#include <cstdint>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/RecyclingStore.h"
+
+namespace CPTutorial {
+
+  MonotonicArena::MonotonicArena(std::size_t blockSize)
+    : m_blocks(),
+      m_current(0),
+      m_offset(0),
+      m_usedBefore(0),
+      m_blockSize(std::max<std::size_t>(blockSize, 64))
+  {}
+
+  void* MonotonicArena::allocate(std::size_t size, std::size_t alignment)
+  {
+    while(true) {
+      if(m_current < m_blocks.size()) {
+        Block& block = m_blocks[m_current];
+        const std::uintptr_t base =
+          reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t start =
+          (base + m_offset + alignment - 1) / alignment * alignment - base;
+        if(start + size <= block.size) {
+          m_offset = start + size;
+          return block.data.get() + start;
+        }
+        // Move on to the next block, if there is one from earlier events
+        if(m_current + 1 < m_blocks.size()) {
+          m_usedBefore += m_offset;
+          ++m_current;
+          m_offset = 0;
+          continue;
+        }
+      }
+
+      // Grow geometrically, so the number of blocks stays small
+      while(m_blockSize < size + alignment) m_blockSize *= 2;
+      Block block;
+      block.data.reset(new char[m_blockSize]);
+      block.size = m_blockSize;
+      if(!m_blocks.empty()) m_usedBefore += m_offset;
+      m_blocks.push_back(std::move(block));
+      m_current = m_blocks.size() - 1;
+      m_offset = 0;
+      m_blockSize *= 2;
+    }
+  }
+
+  void MonotonicArena::reset()
+  {
+    m_current = 0;
+    m_offset = 0;
+    m_usedBefore = 0;
+  }
+
+  std::size_t MonotonicArena::used() const
+  {
+    return m_usedBefore + m_offset;
+  }
+
+  std::size_t MonotonicArena::capacity() const
+  {
+    std::size_t result = 0;
+    for(std::size_t i = 0; i < m_blocks.size(); ++i) {
+      result += m_blocks[i].size;
+    }
+    return result;
+  }
+
+  RecyclingStats::RecyclingStats()
+    : nCreated(0),
+      nReused(0),
+      arenaCapacity(0)
+  {}
+
+  RecyclingStats& RecyclingStats::operator+=(const RecyclingStats& rhs)
+  {
+    nCreated += rhs.nCreated;
+    nReused += rhs.nReused;
+    arenaCapacity = std::max(arenaCapacity, rhs.arenaCapacity);
+    return *this;
+  }
+
+  RecyclingStore::RecyclingStore()
+    : m_slots(),
+      m_live(),
+      m_arena(),
+      m_stats()
+  {}
+
+  RecyclingStore::~RecyclingStore()
+  {}
+
+  bool RecyclingStore::contains(const std::string& key) const
+  {
+    std::unordered_map<std::string,
+                       std::unique_ptr<SlotBase> >::const_iterator itr =
+      m_slots.find(key);
+    return (itr != m_slots.end() && itr->second->live);
+  }
+
+  void RecyclingStore::clear()
+  {
+    for(std::size_t i = 0; i < m_live.size(); ++i) {
+      m_live[i]->reset();
+      m_live[i]->live = false;
+    }
+    m_live.clear();
+    m_stats.arenaCapacity = std::max(m_stats.arenaCapacity,
+                                     m_arena.capacity());
+    m_arena.reset();
+  }
+
+  RecyclingStats RecyclingStore::stats() const
+  {
+    RecyclingStats result = m_stats;
+    result.arenaCapacity = std::max(result.arenaCapacity, m_arena.capacity());
+    return result;
+  }
+
+  void RecyclingStore::typeMismatch(const std::string& key,
+                                    const std::type_info& requested,
+                                    const std::type_info& stored) const
+  {
+    ::Error("RecyclingStore", "Object \"%s\" requested as %s, but it is "
+            "stored as %s", key.c_str(), requested.name(), stored.name());
+  }
+
+} // namespace CPTutorial
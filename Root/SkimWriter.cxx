@@ -0,0 +1,119 @@
+// System includes
+#include <algorithm>
+
+// ROOT includes
+#include "TFile.h"
+#include "TTree.h"
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/SkimWriter.h"
+#include "CPTutorialExample/Check.h"
+
+namespace CPTutorial {
+
+  SkimWriter::SkimWriter()
+    : m_output(),
+      m_file(),
+      m_tree(0),
+      m_metaTree(0),
+      m_entriesWritten(0),
+      m_nFiles(0),
+      m_nFastFiles(0)
+  {}
+
+  SkimWriter::~SkimWriter()
+  {}
+
+  StatusCode SkimWriter::open(const std::string& fileName,
+                              const OutputConfig& output)
+  {
+    const char* APP_NAME = "SkimWriter";
+    m_output = output;
+    m_file.reset(TFile::Open(fileName.c_str(), "RECREATE"));
+    CPT_RETURN_CHECK( APP_NAME, m_file.get() && !m_file->IsZombie() );
+    configureOutputFile(*m_file, m_output);
+    Info(APP_NAME, "Writing the selected events to %s", fileName.c_str());
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode SkimWriter::addFile(const std::string& fileName,
+                                 std::vector<Long64_t> entries,
+                                 bool copyMetaData)
+  {
+    const char* APP_NAME = "SkimWriter";
+    CPT_RETURN_CHECK( APP_NAME, m_file.get() );
+    std::unique_ptr<TFile> input(TFile::Open(fileName.c_str(), "READ"));
+    CPT_RETURN_CHECK( APP_NAME, input.get() && !input->IsZombie() );
+    TTree* tree = dynamic_cast<TTree*>(input->Get("CollectionTree"));
+    CPT_RETURN_CHECK( APP_NAME, tree );
+    const Long64_t fileEntries = tree->GetEntries();
+    ++m_nFiles;
+
+    // The workers hand in their entries in no particular order
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    if(static_cast<Long64_t>(entries.size()) == fileEntries) {
+      CPT_RETURN_CHECK( APP_NAME, cloneTree(*tree, m_tree) );
+      if(copyBaskets()) ++m_nFastFiles;
+    }
+    else if(!entries.empty()) {
+      if(!m_tree) {
+        m_file->cd();
+        m_tree = tree->CloneTree(0);
+        CPT_RETURN_CHECK( APP_NAME, m_tree );
+        m_tree->SetDirectory(m_file.get());
+        configureOutputTree(*m_tree, m_output);
+      }
+      tree->CopyAddresses(m_tree);
+      for(std::size_t i = 0; i < entries.size(); ++i) {
+        CPT_RETURN_CHECK( APP_NAME, tree->GetEntry(entries[i]) >= 0 );
+        CPT_RETURN_CHECK( APP_NAME, m_tree->Fill() >= 0 );
+      }
+      // The objects belong to the input tree, which goes away here
+      tree->CopyAddresses(m_tree, kTRUE);
+    }
+    m_entriesWritten += entries.size();
+
+    // Without its metadata the output could not be read as an xAOD
+    TTree* metaTree = dynamic_cast<TTree*>(input->Get("MetaData"));
+    if(metaTree && copyMetaData) {
+      CPT_RETURN_CHECK( APP_NAME, cloneTree(*metaTree, m_metaTree) );
+    }
+    input->Close();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode SkimWriter::cloneTree(TTree& input, TTree*& output)
+  {
+    const char* APP_NAME = "SkimWriter";
+    if(!output) {
+      m_file->cd();
+      output = input.CloneTree(0);
+      CPT_RETURN_CHECK( APP_NAME, output );
+      output->SetDirectory(m_file.get());
+      configureOutputTree(*output, m_output);
+    }
+    CPT_RETURN_CHECK( APP_NAME, output->CopyEntries(
+                        &input, -1, copyBaskets() ? "fast" : "") >= 0 );
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode SkimWriter::close()
+  {
+    const char* APP_NAME = "SkimWriter";
+    if(!m_file) return StatusCode::SUCCESS;
+    m_file->cd();
+    if(m_tree) CPT_RETURN_CHECK( APP_NAME, m_tree->Write() > 0 );
+    if(m_metaTree) CPT_RETURN_CHECK( APP_NAME, m_metaTree->Write() > 0 );
+    m_file->Close();
+    m_file.reset();
+    m_tree = 0;
+    m_metaTree = 0;
+    Info(APP_NAME, "Kept %lli events of %u input files, %u of them copied "
+         "without decompressing", m_entriesWritten, m_nFiles, m_nFastFiles);
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
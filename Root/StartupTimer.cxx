@@ -0,0 +1,98 @@
+// System includes
+#include <fstream>
+#include <sstream>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/StartupTimer.h"
+
+namespace {
+
+  /// How long the process has been running [s], or -1 if not known
+  double processAge()
+  {
+#ifdef __linux__
+    // The start time is the 22nd field of /proc/self/stat, in clock
+    // ticks after boot. The second field, the command, is in brackets
+    // and may contain spaces.
+    std::ifstream statFile("/proc/self/stat");
+    std::string stat;
+    std::getline(statFile, stat);
+    const std::string::size_type command = stat.rfind(')');
+    if(command == std::string::npos) return -1;
+    std::istringstream fields(stat.substr(command + 1));
+    std::string field;
+    for(int i = 3; i < 22 && fields >> field; ++i) {}
+    unsigned long long startTicks = 0;
+    if(!(fields >> startTicks)) return -1;
+
+    std::ifstream uptimeFile("/proc/uptime");
+    double uptime = 0;
+    if(!(uptimeFile >> uptime)) return -1;
+    const long ticks = ::sysconf(_SC_CLK_TCK);
+    if(ticks <= 0) return -1;
+    const double age = uptime - double(startTicks) / ticks;
+    return age >= 0 ? age : -1;
+#else
+    return -1;
+#endif
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  StartupTimer::StartupTimer()
+    : m_mutex(),
+      m_beforeStart(processAge()),
+      m_start(clock::now()),
+      m_last(m_start),
+      m_steps()
+  {}
+
+  void StartupTimer::mark(const std::string& step)
+  {
+    const clock::time_point now = clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_steps.push_back(std::make_pair(
+      step, std::chrono::duration<double>(now - m_last).count()));
+    m_last = now;
+  }
+
+  void StartupTimer::markOnce(const std::string& step)
+  {
+    const clock::time_point now = clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(std::size_t i = 0; i < m_steps.size(); ++i) {
+      if(m_steps[i].first == step) return;
+    }
+    m_steps.push_back(std::make_pair(
+      step, std::chrono::duration<double>(now - m_last).count()));
+    m_last = now;
+  }
+
+  void StartupTimer::print(const char* location) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Info(location, "Start-up steps:");
+    double total = 0;
+    if(m_beforeStart >= 0) {
+      // Only resolved to the clock ticks of the kernel, usually 10 ms
+      Info(location, "  %-36s %8.3f s", "Libraries and dictionaries",
+           m_beforeStart);
+      total += m_beforeStart;
+    }
+    for(std::size_t i = 0; i < m_steps.size(); ++i) {
+      Info(location, "  %-36s %8.3f s", m_steps[i].first.c_str(),
+           m_steps[i].second);
+      total += m_steps[i].second;
+    }
+    Info(location, "  %-36s %8.3f s", "Total", total);
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,195 @@
+// ROOT includes
+#include "TError.h"
+
+// System includes
+#include <algorithm>
+
+// Infrastructure includes
+#include "PATInterfaces/ISystematicsTool.h"
+#include "PATInterfaces/SystematicCode.h"
+#include "PATInterfaces/SystematicVariation.h"
+#include "PATInterfaces/SystematicsUtil.h"
+
+// Local includes
+#include "CPTutorialExample/SystematicsDriver.h"
+
+namespace {
+
+  /// Names of the variations of a set that affect any of the tools
+  std::string affectingVariations(
+    const std::vector<CP::ISystematicsTool*>& tools,
+    const CP::SystematicSet& sys)
+  {
+    std::string result;
+    for(CP::SystematicSet::const_iterator var = sys.begin();
+        var != sys.end(); ++var) {
+      for(std::size_t i = 0; i < tools.size(); ++i) {
+        if(tools[i]->isAffectedBySystematic(*var)) {
+          result += var->name();
+          result += ' ';
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  SystematicsDriver::SystematicsDriver()
+    : m_tools(),
+      m_containers(),
+      m_systematics(1, CP::SystematicSet()),
+      m_affectsAny(1, true),
+      m_current(-1),
+      m_keys()
+  {}
+
+  void SystematicsDriver::addTool(CP::ISystematicsTool* tool)
+  {
+    if(tool && std::find(m_tools.begin(), m_tools.end(), tool) ==
+       m_tools.end()) {
+      m_tools.push_back(tool);
+    }
+  }
+
+  std::size_t SystematicsDriver::addTool(CP::ISystematicsTool* tool,
+                                         const std::string& container)
+  {
+    addTool(tool);
+    std::size_t index = findContainer(container);
+    if(index == std::string::npos) {
+      index = m_containers.size();
+      m_containers.push_back(Container());
+      m_containers.back().key = container;
+      m_containers.back().source.assign(1, 0);
+      m_containers.back().keys.assign(1, container);
+    }
+    if(tool) m_containers[index].tools.push_back(tool);
+    return index;
+  }
+
+  std::size_t SystematicsDriver::findContainer(const std::string& key) const
+  {
+    for(std::size_t i = 0; i < m_containers.size(); ++i) {
+      if(m_containers[i].key == key) return i;
+    }
+    return std::string::npos;
+  }
+
+  StatusCode
+  SystematicsDriver::initialize(const std::vector<std::string>& names)
+  {
+    m_systematics.assign(1, CP::SystematicSet());
+    m_current = -1;
+    m_keys.clear();
+
+    if(names.size() == 1 && names[0] == "all") {
+      // Everything the registered tools recommend
+      CP::SystematicSet recommended;
+      for(std::size_t i = 0; i < m_tools.size(); ++i) {
+        recommended.insert(m_tools[i]->recommendedSystematics());
+      }
+      m_systematics = CP::make_systematics_vector(recommended);
+    }
+    else {
+      for(std::size_t i = 0; i < names.size(); ++i) {
+        CP::SystematicSet set;
+        set.insert(CP::SystematicVariation(names[i]));
+        m_systematics.push_back(set);
+      }
+    }
+
+    if(m_systematics.empty() || !m_systematics[0].empty()) {
+      ::Error("SystematicsDriver", "The nominal set must come first");
+      return StatusCode::FAILURE;
+    }
+
+    // Find the sets that affect anything at all
+    const std::size_t nSys = m_systematics.size();
+    m_affectsAny.assign(nSys, false);
+    m_affectsAny[0] = true;
+    std::size_t nActive = 1;
+    for(std::size_t sys = 1; sys < nSys; ++sys) {
+      m_affectsAny[sys] =
+        !affectingVariations(m_tools, m_systematics[sys]).empty();
+      if(m_affectsAny[sys]) ++nActive;
+    }
+
+    // For every container, find the sets that change it. Sets affecting a
+    // container through the same variations share the same copy, most
+    // share the nominal one.
+    std::size_t nCopies = 0;
+    for(std::size_t c = 0; c < m_containers.size(); ++c) {
+      Container& cont = m_containers[c];
+      cont.source.assign(nSys, 0);
+      cont.keys.assign(1, cont.key);
+      std::vector<std::string> affecting(nSys);
+      for(std::size_t sys = 1; sys < nSys; ++sys) {
+        affecting[sys] = affectingVariations(cont.tools, m_systematics[sys]);
+        cont.keys.push_back(cont.key + "_" + m_systematics[sys].name());
+        if(affecting[sys].empty()) continue;
+        cont.source[sys] = sys;
+        for(std::size_t prev = 1; prev < sys; ++prev) {
+          if(affecting[prev] == affecting[sys]) {
+            cont.source[sys] = cont.source[prev];
+            break;
+          }
+        }
+        if(cont.source[sys] == sys) ++nCopies;
+      }
+    }
+
+    if(nSys > 1) {
+      ::Info("SystematicsDriver", "Running %u of %u systematic sets per "
+             "event, %u varied container copies",
+             static_cast<unsigned int>(nActive),
+             static_cast<unsigned int>(nSys),
+             static_cast<unsigned int>(nCopies));
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode SystematicsDriver::apply(std::size_t index)
+  {
+    if(m_current == static_cast<long>(index)) return StatusCode::SUCCESS;
+    const CP::SystematicSet& sys = m_systematics[index];
+    for(std::size_t i = 0; i < m_tools.size(); ++i) {
+      if(m_tools[i]->applySystematicVariation(sys) != CP::SystematicCode::Ok) {
+        ::Error("SystematicsDriver", "Failed to apply systematic \"%s\"",
+                sys.name().c_str());
+        m_current = -1;
+        return StatusCode::FAILURE;
+      }
+    }
+    m_current = index;
+    return StatusCode::SUCCESS;
+  }
+
+  bool SystematicsDriver::needsUpdate(const std::string& container,
+                                      std::size_t index) const
+  {
+    const std::size_t c = findContainer(container);
+    return c == std::string::npos || needsUpdate(c, index);
+  }
+
+  const std::string& SystematicsDriver::containerKey(const std::string& base,
+                                                     std::size_t index)
+  {
+    const std::size_t c = findContainer(base);
+    if(c != std::string::npos) return containerKey(c, index);
+
+    std::vector<std::string>& keys = m_keys[base];
+    if(keys.empty()) {
+      keys.reserve(m_systematics.size());
+      for(std::size_t i = 0; i < m_systematics.size(); ++i) {
+        keys.push_back(m_systematics[i].empty() ? base :
+                       base + "_" + m_systematics[i].name());
+      }
+    }
+    return keys[index];
+  }
+
+} // namespace CPTutorial
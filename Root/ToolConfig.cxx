@@ -0,0 +1,190 @@
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/ToolConfig.h"
+#include "CPTutorialExample/ToolStage.h"
+
+namespace {
+
+  /// Read an optional string member of a stage
+  bool stringMember(const CPTutorial::JsonValue& stage, const char* key,
+                    std::size_t index, std::string& value)
+  {
+    const CPTutorial::JsonValue* member = stage.member(key);
+    if(!member) return true;
+    if(!member->isString()) {
+      ::Error("ToolConfig", "\"%s\" of tool #%u must be a string", key,
+              static_cast<unsigned int>(index));
+      return false;
+    }
+    value = member->string();
+    return true;
+  }
+
+  /// Complain about a property of the wrong type
+  StatusCode wrongType(const CPTutorial::ToolConfig& config,
+                       const std::string& property, const char* expected)
+  {
+    ::Error("ToolConfig", "Property %s of %s must be a %s", property.c_str(),
+            config.name.c_str(), expected);
+    return StatusCode::FAILURE;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  ToolConfig::ToolConfig()
+    : type(),
+      name(),
+      enabled(true),
+      container(),
+      properties(),
+      m_read()
+  {}
+
+  bool ToolConfig::readFile(const std::string& fileName,
+                            std::vector<ToolConfig>& tools)
+  {
+    JsonValue document;
+    if(!JsonValue::readFile(fileName, document)) return false;
+    const JsonValue* list = document.member("tools");
+    if(!list || !list->isArray()) {
+      ::Error("ToolConfig", "%s has no \"tools\" array", fileName.c_str());
+      return false;
+    }
+
+    tools.clear();
+    for(std::size_t i = 0; i < list->array().size(); ++i) {
+      const JsonValue& stage = list->array()[i];
+      if(!stage.isObject()) {
+        ::Error("ToolConfig", "Tool #%u of %s is not an object",
+                static_cast<unsigned int>(i), fileName.c_str());
+        return false;
+      }
+      ToolConfig config;
+      if(!stringMember(stage, "type", i, config.type) ||
+         !stringMember(stage, "name", i, config.name) ||
+         !stringMember(stage, "container", i, config.container)) {
+        return false;
+      }
+      const JsonValue* enabled = stage.member("enabled");
+      if(enabled && !enabled->isBool()) {
+        ::Error("ToolConfig", "\"enabled\" of tool #%u must be a boolean",
+                static_cast<unsigned int>(i));
+        return false;
+      }
+      if(enabled) config.enabled = enabled->boolean();
+      const JsonValue* properties = stage.member("properties");
+      if(properties && !properties->isObject()) {
+        ::Error("ToolConfig", "\"properties\" of tool #%u must be an "
+                "object", static_cast<unsigned int>(i));
+        return false;
+      }
+      if(properties) config.properties = *properties;
+      if(config.name.empty()) config.name = config.type;
+
+      // Unknown types are caught here, before any event is read
+      if(config.type.empty() || !ToolStageFactory::has(config.type)) {
+        ::Error("ToolConfig", "Unknown tool type \"%s\" of tool #%u",
+                config.type.c_str(), static_cast<unsigned int>(i));
+        return false;
+      }
+      if(!config.enabled) {
+        ::Info("ToolConfig", "Tool %s is disabled", config.name.c_str());
+        continue;
+      }
+      tools.push_back(config);
+    }
+    return true;
+  }
+
+  bool ToolConfig::has(const std::string& property) const
+  {
+    return findProperty(property) != 0;
+  }
+
+  std::vector<std::string> ToolConfig::unreadProperties() const
+  {
+    std::vector<std::string> result;
+    if(!properties.isObject()) return result;
+    std::map<std::string, JsonValue>::const_iterator itr =
+      properties.object().begin();
+    for(; itr != properties.object().end(); ++itr) {
+      if(!m_read.count(itr->first)) result.push_back(itr->first);
+    }
+    return result;
+  }
+
+  const JsonValue* ToolConfig::findProperty(const std::string& name) const
+  {
+    m_read.insert(name);
+    return properties.member(name);
+  }
+
+  StatusCode ToolConfig::getString(const std::string& property,
+                                   std::string& value) const
+  {
+    const JsonValue* json = findProperty(property);
+    if(!json) return StatusCode::SUCCESS;
+    if(!json->isString()) return wrongType(*this, property, "string");
+    value = json->string();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode ToolConfig::getDouble(const std::string& property,
+                                   double& value) const
+  {
+    const JsonValue* json = findProperty(property);
+    if(!json) return StatusCode::SUCCESS;
+    if(!json->isNumber()) return wrongType(*this, property, "number");
+    value = json->number();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode ToolConfig::getBool(const std::string& property,
+                                 bool& value) const
+  {
+    const JsonValue* json = findProperty(property);
+    if(!json) return StatusCode::SUCCESS;
+    if(!json->isBool()) return wrongType(*this, property, "boolean");
+    value = json->boolean();
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode ToolConfig::getStrings(const std::string& property,
+                                    std::vector<std::string>& value) const
+  {
+    const JsonValue* json = findProperty(property);
+    if(!json) return StatusCode::SUCCESS;
+    if(!json->isArray()) return wrongType(*this, property, "list of strings");
+    std::vector<std::string> result;
+    for(std::size_t i = 0; i < json->array().size(); ++i) {
+      if(!json->array()[i].isString()) {
+        return wrongType(*this, property, "list of strings");
+      }
+      result.push_back(json->array()[i].string());
+    }
+    value.swap(result);
+    return StatusCode::SUCCESS;
+  }
+
+  StatusCode ToolConfig::getDoubles(const std::string& property,
+                                    std::vector<double>& value) const
+  {
+    const JsonValue* json = findProperty(property);
+    if(!json) return StatusCode::SUCCESS;
+    if(!json->isArray()) return wrongType(*this, property, "list of numbers");
+    std::vector<double> result;
+    for(std::size_t i = 0; i < json->array().size(); ++i) {
+      if(!json->array()[i].isNumber()) {
+        return wrongType(*this, property, "list of numbers");
+      }
+      result.push_back(json->array()[i].number());
+    }
+    value.swap(result);
+    return StatusCode::SUCCESS;
+  }
+
+} // namespace CPTutorial
@@ -0,0 +1,67 @@
+// System includes
+#include <map>
+#include <mutex>
+
+// Local includes
+#include "CPTutorialExample/ToolStage.h"
+
+namespace {
+
+  /// The registered stage types
+  ///
+  /// A function-local static, so that it exists whenever the first
+  /// registration happens during static initialisation.
+  struct Registry {
+    std::mutex mutex;
+    std::map<std::string, CPTutorial::ToolStageFactory::Creator> creators;
+  };
+  Registry& registry()
+  {
+    static Registry instance;
+    return instance;
+  }
+
+} // private namespace
+
+namespace CPTutorial {
+
+  bool ToolStageFactory::add(const std::string& type, Creator creator)
+  {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.creators.insert(std::make_pair(type, creator)).second;
+  }
+
+  bool ToolStageFactory::has(const std::string& type)
+  {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.creators.count(type) != 0;
+  }
+
+  std::unique_ptr<ToolStage> ToolStageFactory::create(const std::string& type)
+  {
+    Creator creator = 0;
+    {
+      Registry& reg = registry();
+      std::lock_guard<std::mutex> lock(reg.mutex);
+      std::map<std::string, Creator>::const_iterator itr =
+        reg.creators.find(type);
+      if(itr != reg.creators.end()) creator = itr->second;
+    }
+    return std::unique_ptr<ToolStage>(creator ? creator() : 0);
+  }
+
+  std::vector<std::string> ToolStageFactory::types()
+  {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<std::string> result;
+    for(std::map<std::string, Creator>::const_iterator itr =
+          reg.creators.begin(); itr != reg.creators.end(); ++itr) {
+      result.push_back(itr->first);
+    }
+    return result;
+  }
+
+} // namespace CPTutorial
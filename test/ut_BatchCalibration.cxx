@@ -0,0 +1,149 @@
+// Unit test of BatchCalibration.h: the EtaBinnedScale kernel against a
+// plain per-object calculation, and the gather/scatter of containers.
+
+// System includes
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+
+// EDM includes
+#include "xAODJet/JetContainer.h"
+#include "xAODJet/JetAuxContainer.h"
+
+// Local includes
+#include "CPTutorialExample/BatchCalibration.h"
+#include "CPTutorialExample/Check.h"
+
+/// Helper macro for checking the test conditions
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
+  } while( false )
+
+namespace {
+
+  const float ETA_MAX = 2.5f;
+
+  /// The calibration of one object, written the obvious way
+  float referenceScale(float pt, float eta, const std::vector<float>& scales)
+  {
+    const float absEta = std::fabs(eta);
+    std::size_t bin = scales.size() - 1;
+    if(absEta < ETA_MAX) {
+      bin = static_cast<std::size_t>(absEta / ETA_MAX * scales.size());
+    }
+    return pt * scales[bin];
+  }
+
+  /// Whether two results agree, with NaN agreeing with NaN
+  bool same(float a, float b)
+  {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+  }
+
+  /// Add a jet with the given pt and eta to a container
+  void addJet(xAOD::JetContainer& jets, float pt, float eta)
+  {
+    static const SG::AuxElement::Accessor<float> ptAcc("pt");
+    static const SG::AuxElement::Accessor<float> etaAcc("eta");
+    xAOD::Jet* jet = new xAOD::Jet();
+    jets.push_back(jet);
+    ptAcc(*jet) = pt;
+    etaAcc(*jet) = eta;
+  }
+
+} // private namespace
+
+int main()
+{
+  const char* APP_NAME = "ut_BatchCalibration";
+
+  // Two containers of jets, as the events of a block. The second one
+  // has the edge cases: bin edges, etaMax itself, beyond etaMax, and
+  // NaN values.
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  xAOD::JetContainer first, second;
+  xAOD::JetAuxContainer firstAux, secondAux;
+  first.setStore(&firstAux);
+  second.setStore(&secondAux);
+  addJet(first, 25000.f, 0.1f);
+  addJet(first, 40000.f, -1.3f);
+  addJet(first, 120000.f, 2.2f);
+  addJet(second, 30000.f, 0.f);
+  addJet(second, 30000.f, 0.5f);
+  addJet(second, 30000.f, -1.f);
+  addJet(second, 30000.f, ETA_MAX);
+  addJet(second, 30000.f, -4.5f);
+  addJet(second, 30000.f, 1e30f);
+  addJet(second, 30000.f, -inf);
+  addJet(second, 30000.f, nan);
+  addJet(second, nan, 1.7f);
+
+  std::vector<std::string> variables;
+  variables.push_back("pt");
+  variables.push_back("eta");
+  CPTutorial::ObjectBatch batch(variables);
+  const std::size_t firstOffset = batch.gather(first);
+  const std::size_t secondOffset = batch.gather(second);
+  CHECK( firstOffset == 0 );
+  CHECK( secondOffset == first.size() );
+  CHECK( batch.size() == first.size() + second.size() );
+  CHECK( batch.index("eta") == 1 );
+  CHECK( batch.index("phi") == CPTutorial::ObjectBatch::npos );
+
+  std::vector<float> scales;
+  scales.push_back(1.02f);
+  scales.push_back(1.03f);
+  scales.push_back(1.05f);
+  scales.push_back(1.08f);
+  scales.push_back(1.12f);
+  CPTutorial::EtaBinnedScale kernel(ETA_MAX, scales);
+  CHECK( kernel.initialize(batch).isSuccess() );
+  std::vector<float> calibrated(batch.size());
+  kernel.apply(batch, calibrated.data());
+
+  // Compare with the per-object calculation
+  const float* pt = batch.column(batch.index("pt"));
+  const float* eta = batch.column(batch.index("eta"));
+  for(std::size_t i = 0; i < batch.size(); ++i) {
+    const float expected = referenceScale(pt[i], eta[i], scales);
+    if(!same(calibrated[i], expected)) {
+      Error(APP_NAME, "Object %u: %g instead of %g",
+            static_cast<unsigned int>(i), calibrated[i], expected);
+      return 1;
+    }
+  }
+  CHECK( calibrated[secondOffset + 3] == 30000.f * scales.back() );
+  CHECK( calibrated[secondOffset + 7] == 30000.f * scales.back() );
+  CHECK( std::isnan(calibrated[secondOffset + 8]) );
+
+  // Write the results back, and find them on the jets
+  const SG::AuxElement::Decorator<float> decorator("ptScaled");
+  CPTutorial::scatter(first, firstOffset, calibrated.data(), decorator);
+  CPTutorial::scatter(second, secondOffset, calibrated.data(), decorator);
+  const SG::AuxElement::ConstAccessor<float> scaled("ptScaled");
+  CHECK( scaled(*first[2]) == calibrated[2] );
+  CHECK( scaled(*second[1]) == calibrated[secondOffset + 1] );
+
+  // Clearing keeps the layout, for the next block
+  batch.clear();
+  CHECK( batch.size() == 0 );
+  CHECK( batch.gather(second) == 0 );
+  CHECK( kernel.initialize(batch).isSuccess() );
+
+  // A batch without the eta column can't be used
+  CPTutorial::ObjectBatch ptOnly(std::vector<std::string>(1, "pt"));
+  CHECK( kernel.initialize(ptOnly).isFailure() );
+
+  return 0;
+}
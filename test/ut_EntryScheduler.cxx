@@ -0,0 +1,162 @@
+// Unit test of EntryScheduler: the grouping of entries into windows,
+// the order of the groups a worker gets, stealing, and termination.
+
+// System includes
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/EntryScheduler.h"
+#include "CPTutorialExample/Check.h"
+
+/// Helper macro for checking the test conditions
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
+  } while( false )
+
+namespace {
+
+  /// A group of one range
+  CPTutorial::EntryGroup group(Long64_t begin, Long64_t end)
+  {
+    return CPTutorial::EntryGroup(1, CPTutorial::EntryRange(begin, end));
+  }
+
+  /// Whether a worker gets the expected group next
+  bool nextIs(CPTutorial::EntryScheduler& scheduler, unsigned int worker,
+              Long64_t begin, bool stolen)
+  {
+    CPTutorial::EntryGroup result;
+    bool wasStolen = !stolen;
+    return scheduler.next(worker, result, wasStolen) &&
+      !result.empty() && result.front().begin == begin &&
+      wasStolen == stolen;
+  }
+
+  /// Whether a worker is told that there is no work left
+  bool isDone(CPTutorial::EntryScheduler& scheduler, unsigned int worker)
+  {
+    CPTutorial::EntryGroup result;
+    bool stolen = true;
+    return !scheduler.next(worker, result, stolen) && !stolen;
+  }
+
+  /// Process all groups of a scheduler, noting the entries seen
+  void work(CPTutorial::EntryScheduler* scheduler, unsigned int worker,
+            std::vector<Long64_t>* seen)
+  {
+    CPTutorial::EntryGroup result;
+    bool stolen = false;
+    while(scheduler->next(worker, result, stolen)) {
+      for(std::size_t i = 0; i < result.size(); ++i) {
+        for(Long64_t e = result[i].begin; e < result[i].end; ++e) {
+          seen->push_back(e);
+        }
+      }
+    }
+  }
+
+} // private namespace
+
+int main()
+{
+  const char* APP_NAME = "ut_EntryScheduler";
+
+  // Without a tree, the ranges are grouped by windows of 10 entries,
+  // and cut at the window edges
+  std::vector<CPTutorial::EntryRange> ranges;
+  ranges.push_back(CPTutorial::EntryRange(3, 5));
+  ranges.push_back(CPTutorial::EntryRange(7, 12));
+  ranges.push_back(CPTutorial::EntryRange(15, 16));
+  ranges.push_back(CPTutorial::EntryRange(25, 47));
+  ranges.push_back(CPTutorial::EntryRange(60, 61));
+  std::vector<CPTutorial::EntryGroup> groups =
+    CPTutorial::clusterGroups(0, ranges, 10);
+  CHECK( groups.size() == 6 );
+  CHECK( groups[0].size() == 2 && groups[0][1].end == 10 );
+  CHECK( groups[1].size() == 2 && groups[1][0].begin == 10 );
+  CHECK( groups[2].size() == 1 && groups[2][0].end == 30 );
+  CHECK( groups[3].size() == 1 && groups[3][0].size() == 10 );
+  CHECK( groups[4].size() == 1 && groups[4][0].end == 47 );
+  CHECK( groups[5].size() == 1 && groups[5][0].begin == 60 );
+  CHECK( CPTutorial::clusterGroups(0, ranges, 0).size() == 31 );
+  CHECK( CPTutorial::clusterGroups(0, ranges, 1000).size() == 1 );
+  CHECK( CPTutorial::clusterGroups(0,
+           std::vector<CPTutorial::EntryRange>()).empty() );
+
+  // The first worker gets the first 23 of the 31 entries, and the
+  // second one steals from the back of its queue once done
+  CPTutorial::EntryScheduler two(groups, 2);
+  CHECK( two.nWorkers() == 2 );
+  CHECK( nextIs(two, 1, 40, false) );
+  CHECK( nextIs(two, 1, 60, false) );
+  CHECK( nextIs(two, 1, 30, true) );
+  CHECK( nextIs(two, 0, 3, false) );
+  CHECK( nextIs(two, 1, 25, true) );
+  CHECK( nextIs(two, 0, 10, false) );
+  CHECK( isDone(two, 0) );
+  CHECK( isDone(two, 1) );
+  CHECK( isDone(two, 0) );
+
+  // Stealing goes to the worker with the most entries left
+  std::vector<CPTutorial::EntryGroup> uneven;
+  uneven.push_back(group(0, 10));
+  uneven.push_back(group(10, 20));
+  uneven.push_back(group(20, 21));
+  uneven.push_back(group(21, 22));
+  uneven.push_back(group(22, 52));
+  CPTutorial::EntryScheduler three(uneven, 3);
+  CHECK( nextIs(three, 2, 22, true) );
+  CHECK( nextIs(three, 2, 10, true) );
+  CHECK( nextIs(three, 2, 0, true) );
+  CHECK( nextIs(three, 2, 21, true) );
+  CHECK( nextIs(three, 2, 20, true) );
+  CHECK( isDone(three, 0) );
+  CHECK( isDone(three, 1) );
+  CHECK( isDone(three, 2) );
+
+  // Without workers there is still one, getting everything in order
+  CPTutorial::EntryScheduler single(groups, 0);
+  CHECK( single.nWorkers() == 1 );
+  for(std::size_t i = 0; i < groups.size(); ++i) {
+    CHECK( nextIs(single, 0, groups[i].front().begin, false) );
+  }
+  CHECK( isDone(single, 0) );
+  CPTutorial::EntryScheduler nothing(std::vector<CPTutorial::EntryGroup>(),
+                                     4);
+  CHECK( isDone(nothing, 3) );
+
+  // Workers running concurrently see every entry exactly once
+  const unsigned int nWorkers = 4;
+  const Long64_t nEntries = 100000;
+  CPTutorial::EntryScheduler concurrent(
+    CPTutorial::clusterGroups(0, std::vector<CPTutorial::EntryRange>(
+      1, CPTutorial::EntryRange(0, nEntries)), 7), nWorkers);
+  std::vector<std::vector<Long64_t> > seen(nWorkers);
+  std::vector<std::thread> threads;
+  for(unsigned int i = 0; i < nWorkers; ++i) {
+    threads.push_back(std::thread(work, &concurrent, i, &seen[i]));
+  }
+  std::vector<Long64_t> all;
+  for(unsigned int i = 0; i < nWorkers; ++i) {
+    threads[i].join();
+    all.insert(all.end(), seen[i].begin(), seen[i].end());
+  }
+  std::sort(all.begin(), all.end());
+  CHECK( all.size() == static_cast<std::size_t>(nEntries) );
+  for(Long64_t e = 0; e < nEntries; ++e) {
+    CHECK( all[e] == e );
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+// Unit test of EventIndex: writing and reading back index files, the
+// varint encoding of the entries, and the rejection of damaged files.
+
+// System includes
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/EventIndex.h"
+#include "CPTutorialExample/Check.h"
+
+/// Helper macro for checking the test conditions
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
+  } while( false )
+
+namespace {
+
+  const ULong64_t HASH = 0x0123456789abcdefull;
+  const Long64_t TREE_ENTRIES = 1ll << 42;
+
+  /// Read a whole file
+  std::string readFile(const std::string& fileName)
+  {
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+  }
+
+  /// Write a whole file
+  bool writeFile(const std::string& fileName, const std::string& data)
+  {
+    std::ofstream out(fileName.c_str(), std::ios::binary);
+    out << data;
+    return static_cast<bool>(out);
+  }
+
+  /// Replace the checksum at the end of a file image with a matching one
+  std::string resum(std::string data)
+  {
+    data.resize(data.size() - 8);
+    const ULong64_t sum = CPTutorial::fnv1aHash(data);
+    for(int i = 0; i < 8; ++i) data += char((sum >> (8 * i)) & 0xff);
+    return data;
+  }
+
+  /// Whether a file image is accepted as an index of TREE_ENTRIES entries
+  bool accepted(const std::string& fileName, const std::string& data)
+  {
+    CPTutorial::EventIndex index;
+    return writeFile(fileName, data) &&
+      index.read(fileName, HASH, TREE_ENTRIES);
+  }
+
+} // private namespace
+
+int main()
+{
+  const char* APP_NAME = "ut_EventIndex";
+
+  // The hash, against the FNV-1a reference values
+  CHECK( CPTutorial::fnv1aHash("") == 14695981039346656037ull );
+  CHECK( CPTutorial::fnv1aHash("a") == 0xaf63dc4c8601ec8cull );
+
+  // File names, with and without the trailing slash
+  CHECK( CPTutorial::EventIndex::fileName("dir", "UUID", 0xabcull) ==
+         "dir/UUID_0000000000000abc.idx" );
+  CHECK( CPTutorial::EventIndex::fileName("dir/", "UUID", HASH) ==
+         "dir/UUID_0123456789abcdef.idx" );
+
+  // Entries given unsorted and twice, with gaps needing varints of one
+  // to six bytes
+  std::vector<Long64_t> given;
+  given.push_back(1ll << 40);
+  given.push_back(0);
+  given.push_back(127);
+  given.push_back(255);
+  given.push_back(256);
+  given.push_back(257);
+  given.push_back(127);
+  given.push_back(16640);
+  given.push_back(TREE_ENTRIES - 1);
+  CPTutorial::EventIndex index;
+  index.set(TREE_ENTRIES, given);
+  CHECK( index.treeEntries() == TREE_ENTRIES );
+  CHECK( index.entries().size() == 8 );
+  CHECK( index.entries()[0] == 0 && index.entries()[1] == 127 );
+  CHECK( index.entries()[7] == TREE_ENTRIES - 1 );
+
+  // Consecutive entries merge into ranges, cut at the requested range
+  CPTutorial::EntryRange all(0, TREE_ENTRIES);
+  std::vector<CPTutorial::EntryRange> ranges = index.ranges(all);
+  CHECK( ranges.size() == 6 );
+  CHECK( ranges[2].begin == 255 && ranges[2].end == 258 );
+  ranges = index.ranges(CPTutorial::EntryRange(128, 257));
+  CHECK( ranges.size() == 1 );
+  CHECK( ranges[0].begin == 255 && ranges[0].end == 257 );
+  CHECK( index.ranges(CPTutorial::EntryRange(1, 127)).empty() );
+
+  // Round trip through a file
+  const std::string fileName = "ut_EventIndex.idx";
+  const std::string damaged = "ut_EventIndex_damaged.idx";
+  CHECK( index.write(fileName, HASH).isSuccess() );
+  CPTutorial::EventIndex readBack;
+  CHECK( readBack.read(fileName, HASH, TREE_ENTRIES) );
+  CHECK( readBack.treeEntries() == TREE_ENTRIES );
+  CHECK( readBack.entries() == index.entries() );
+
+  // An index for another selection, or another version of the tree
+  CHECK( !readBack.read(fileName, HASH + 1, TREE_ENTRIES) );
+  CHECK( !readBack.read(fileName, HASH, TREE_ENTRIES + 1) );
+  CHECK( !readBack.read("ut_EventIndex_missing.idx", HASH, TREE_ENTRIES) );
+
+  // An empty selection
+  CPTutorial::EventIndex empty;
+  empty.set(TREE_ENTRIES, std::vector<Long64_t>());
+  CHECK( empty.write(damaged, HASH).isSuccess() );
+  CHECK( readBack.read(damaged, HASH, TREE_ENTRIES) );
+  CHECK( readBack.entries().empty() );
+
+  // Damaged files: every flipped byte, every truncation, a wrong magic
+  const std::string good = readFile(fileName);
+  CHECK( accepted(damaged, good) );
+  for(std::size_t i = 0; i < good.size(); ++i) {
+    std::string flipped = good;
+    flipped[i] ^= 0x10;
+    CHECK( !accepted(damaged, flipped) );
+    CHECK( !accepted(damaged, good.substr(0, i)) );
+  }
+  std::string magic = good;
+  magic[7] = '2';
+  CHECK( !accepted(damaged, resum(magic)) );
+
+  // ... and ones with a valid checksum, but impossible contents: the
+  // count of entries off by one, an unterminated varint, an entry
+  // repeated, and an entry beyond the end of the tree
+  const std::size_t countByte = 24;
+  const std::size_t payload = 32;
+  std::string data = good;
+  ++data[countByte];
+  CHECK( !accepted(damaged, resum(data)) );
+  data = good;
+  --data[countByte];
+  CHECK( !accepted(damaged, resum(data)) );
+  data = good;
+  data[data.size() - 9] |= 0x80;
+  CHECK( !accepted(damaged, resum(data)) );
+  data = good;
+  data[payload + 1] = 0;
+  CHECK( !accepted(damaged, resum(data)) );
+  std::vector<Long64_t> beyond(1, TREE_ENTRIES);
+  CPTutorial::EventIndex tooLarge;
+  tooLarge.set(TREE_ENTRIES, beyond);
+  CHECK( tooLarge.write(damaged, HASH).isSuccess() );
+  CHECK( !readBack.read(damaged, HASH, TREE_ENTRIES) );
+
+  std::remove(fileName.c_str());
+  std::remove(damaged.c_str());
+
+  return 0;
+}
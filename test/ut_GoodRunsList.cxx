@@ -0,0 +1,168 @@
+// Unit test of GoodRunsList: the bitmap lookup at the edges of the
+// lumiblock ranges, the cache of the last run, and reading GRL files.
+
+// System includes
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/GoodRunsList.h"
+#include "CPTutorialExample/Check.h"
+
+/// Helper macro for checking the test conditions
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
+  } while( false )
+
+namespace {
+
+  /// A lumiblock range, for the reference lookup
+  struct LBRange {
+    UInt_t run, firstLB, lastLB;
+  };
+
+  /// The lookup written the obvious way
+  bool linearAccept(const std::vector<LBRange>& ranges, UInt_t run,
+                    UInt_t lumiBlock)
+  {
+    for(std::size_t i = 0; i < ranges.size(); ++i) {
+      const LBRange& r = ranges[i];
+      if(r.run == run && lumiBlock >= r.firstLB && lumiBlock <= r.lastLB) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Write a text file
+  bool writeFile(const std::string& fileName, const std::string& text)
+  {
+    std::ofstream out(fileName.c_str());
+    out << text;
+    return static_cast<bool>(out);
+  }
+
+} // private namespace
+
+int main()
+{
+  const char* APP_NAME = "ut_GoodRunsList";
+
+  // Ranges given out of order, overlapping, and across the 64 bit words
+  // of the bitmaps
+  const LBRange given[] = {
+    { 300000, 60, 70 }, { 284500, 1, 10 }, { 284500, 20, 20 },
+    { 300000, 65, 130 }, { 290000, 5, 5 }, { 300000, 200, 255 },
+    { 0, 3, 4 }
+  };
+  const std::size_t nGiven = sizeof(given) / sizeof(given[0]);
+  std::vector<LBRange> ranges(given, given + nGiven);
+  CPTutorial::GoodRunsList grl;
+  CHECK( grl.empty() );
+  for(std::size_t i = 0; i < nGiven; ++i) {
+    grl.addRange(given[i].run, given[i].firstLB, given[i].lastLB);
+  }
+  // Empty ranges are dropped
+  grl.addRange(284500, 50, 40);
+  grl.compile();
+  CHECK( !grl.empty() );
+  CHECK( grl.nRuns() == 4 );
+  // Run 0 as the very first lookup, with nothing in the cache yet
+  CHECK( grl.accept(0, 3) );
+
+  // Every lumiblock around the ranges, with the runs alternating so
+  // that the cache of the last run misses, and in order, so that it hits
+  const UInt_t runs[] = { 0, 1, 284499, 284500, 284501, 290000, 300000,
+                          300001, 0xffffffffu };
+  const std::size_t nRuns = sizeof(runs) / sizeof(runs[0]);
+  for(UInt_t lb = 0; lb < 300; ++lb) {
+    for(std::size_t r = 0; r < nRuns; ++r) {
+      CHECK( grl.accept(runs[r], lb) == linearAccept(ranges, runs[r], lb) );
+    }
+  }
+  for(std::size_t r = 0; r < nRuns; ++r) {
+    for(UInt_t lb = 0; lb < 300; ++lb) {
+      CHECK( grl.accept(runs[r], lb) == linearAccept(ranges, runs[r], lb) );
+    }
+  }
+  CHECK( grl.accept(300000, 127) && grl.accept(300000, 128) );
+  CHECK( !grl.accept(300000, 59) && !grl.accept(300000, 131) );
+  CHECK( !grl.accept(300000, 0xffffffffu) );
+
+  // Lumiblocks beyond MAX_LB are cut off
+  CPTutorial::GoodRunsList large;
+  large.addRange(1, CPTutorial::GoodRunsList::MAX_LB - 1, 0xffffffffu);
+  large.addRange(2, CPTutorial::GoodRunsList::MAX_LB + 1, 0xffffffffu);
+  large.compile();
+  CHECK( large.nRuns() == 1 );
+  CHECK( large.accept(1, CPTutorial::GoodRunsList::MAX_LB) );
+  CHECK( !large.accept(1, CPTutorial::GoodRunsList::MAX_LB + 1) );
+
+  // The description only depends on the good lumiblocks
+  CPTutorial::GoodRunsList same;
+  same.addRange(0, 3, 4);
+  same.addRange(284500, 1, 5);
+  same.addRange(284500, 6, 10);
+  same.addRange(284500, 20, 20);
+  same.addRange(290000, 5, 5);
+  same.addRange(300000, 60, 130);
+  same.addRange(300000, 200, 255);
+  same.compile();
+  CHECK( same.description() == grl.description() );
+  CHECK( grl.description() ==
+         "0:3-4,;284500:1-10,20-20,;290000:5-5,;300000:60-130,200-255,;" );
+
+  // GRL files, and malformed ones
+  const std::string good = "ut_GoodRunsList_good.xml";
+  const std::string bad = "ut_GoodRunsList_bad.xml";
+  CHECK( writeFile(good,
+    "<?xml version=\"1.0\"?>\n"
+    "<LumiRangeCollection>\n"
+    "  <NamedLumiRange>\n"
+    "    <Name>Test</Name>\n"
+    "    <LumiBlockCollection>\n"
+    "      <Run>284500</Run>\n"
+    "      <LBRange Start=\"1\" End=\"10\"/>\n"
+    "      <LBRange Start=\"20\" End=\"20\"/>\n"
+    "    </LumiBlockCollection>\n"
+    "    <LumiBlockCollection>\n"
+    "      <Run>300000</Run>\n"
+    "      <LBRange Start=\"60\" End=\"130\"/>\n"
+    "    </LumiBlockCollection>\n"
+    "  </NamedLumiRange>\n"
+    "</LumiRangeCollection>\n") );
+  CHECK( writeFile(bad,
+    "<?xml version=\"1.0\"?>\n"
+    "<LumiRangeCollection>\n"
+    "  <NamedLumiRange>\n"
+    "    <LumiBlockCollection>\n"
+    "      <Run>284500</Run>\n"
+    "      <LBRange Start=\"1\" End=\"ten\"/>\n"
+    "    </LumiBlockCollection>\n"
+    "  </NamedLumiRange>\n"
+    "</LumiRangeCollection>\n") );
+  CPTutorial::GoodRunsList fromFile;
+  CHECK( fromFile.readXml(good).isSuccess() );
+  fromFile.compile();
+  CHECK( fromFile.nRuns() == 2 );
+  CHECK( fromFile.accept(284500, 20) && !fromFile.accept(284500, 11) );
+  CHECK( fromFile.accept(300000, 130) && !fromFile.accept(290000, 5) );
+  CPTutorial::GoodRunsList malformed;
+  CHECK( malformed.readXml(bad).isFailure() );
+  CHECK( malformed.readXml("ut_GoodRunsList_missing.xml").isFailure() );
+  std::remove(good.c_str());
+  std::remove(bad.c_str());
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+// Unit test of the JSON parser of JsonValue, and of the property
+// bookkeeping of ToolConfig built on it.
+
+// System includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/JsonValue.h"
+#include "CPTutorialExample/ToolConfig.h"
+#include "CPTutorialExample/Check.h"
+
+/// Helper macro for checking the test conditions
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
+  } while( false )
+
+namespace {
+
+  /// Whether a text parses
+  bool parses(const std::string& text)
+  {
+    CPTutorial::JsonValue value;
+    std::string error;
+    return CPTutorial::JsonValue::parse(text, value, error);
+  }
+
+  /// Parse a text that has to be a single number
+  bool number(const std::string& text, double& value)
+  {
+    CPTutorial::JsonValue json;
+    std::string error;
+    if(!CPTutorial::JsonValue::parse(text, json, error) ||
+       !json.isNumber()) {
+      return false;
+    }
+    value = json.number();
+    return true;
+  }
+
+} // private namespace
+
+int main()
+{
+  const char* APP_NAME = "ut_JsonValue";
+
+  // Numbers, as the JSON grammar has them
+  double x = 0;
+  CHECK( number("0", x) && x == 0 );
+  CHECK( number("-0.5", x) && x == -0.5 );
+  CHECK( number("1e3", x) && x == 1000 );
+  CHECK( number("2.5E-1", x) && x == 0.25 );
+  CHECK( number(" 42 ", x) && x == 42 );
+  // ... and what strtod() would also take
+  CHECK( !parses("nan") );
+  CHECK( !parses("inf") );
+  CHECK( !parses("-Infinity") );
+  CHECK( !parses("0x10") );
+  CHECK( !parses("+1") );
+  CHECK( !parses(".5") );
+  CHECK( !parses("1.") );
+  CHECK( !parses("01") );
+  CHECK( !parses("1e") );
+  CHECK( !parses("-") );
+  CHECK( !parses("1e999") );
+  CHECK( !parses("[1, nan]") );
+
+  // Strings and escapes
+  std::string error;
+  CPTutorial::JsonValue value;
+  CHECK( CPTutorial::JsonValue::parse("\"a\\\"b\\\\c\\n\\u00e9\\u20AC\"",
+                                      value, error) );
+  CHECK( value.isString() );
+  CHECK( value.string() == "a\"b\\c\n\xc3\xa9\xe2\x82\xac" );
+  CHECK( !parses("\"\\u00g0\"") );
+  CHECK( !parses("\"\\u-001\"") );
+  CHECK( !parses("\"\\u00\"") );
+  CHECK( !parses("\"\\x\"") );
+  CHECK( !parses("\"open") );
+
+  // Structure
+  CHECK( parses("{}") );
+  CHECK( parses("[]") );
+  CHECK( parses("{ \"a\": [ true, false, null ], \"b\": { \"c\": 1 } }") );
+  CHECK( !parses("") );
+  CHECK( !parses("[1, 2") );
+  CHECK( !parses("[1 2]") );
+  CHECK( !parses("{ \"a\": 1, }") );
+  CHECK( !parses("{ \"a\" 1 }") );
+  CHECK( !parses("{ \"a\": 1, \"a\": 2 }") );
+  CHECK( !parses("{} x") );
+  CHECK( !parses("truex") );
+  std::string deep(64, '[');
+  deep += std::string(64, ']');
+  CHECK( parses(deep) );
+  CHECK( !parses("[" + deep + "]") );
+
+  // Errors name the line of the problem
+  CHECK( !CPTutorial::JsonValue::parse("{\n  \"a\": 1,\n  \"b\": nan\n}", value,
+                                       error) );
+  CHECK( error.find("line 3") != std::string::npos );
+
+  // Members
+  CHECK( CPTutorial::JsonValue::parse("{ \"b\": 2, \"a\": \"x\" }", value,
+                                      error) );
+  CHECK( value.member("a") && value.member("a")->string() == "x" );
+  CHECK( value.member("c") == 0 );
+  CHECK( value.object().begin()->first == "a" );
+
+  // The properties a stage doesn't ask for are reported
+  CPTutorial::ToolConfig config;
+  config.name = "Test";
+  CHECK( CPTutorial::JsonValue::parse("{ \"scale\": 2, \"input\": \"mu\", "
+                                      "\"scael\": 3, \"flag\": true }",
+                                      config.properties, error) );
+  double scale = 1;
+  std::string input;
+  CHECK( config.getDouble("scale", scale).isSuccess() && scale == 2 );
+  CHECK( config.getString("input", input).isSuccess() && input == "mu" );
+  CHECK( config.getString("output", input).isSuccess() && input == "mu" );
+  CHECK( config.getString("scale", input).isFailure() );
+  std::vector<std::string> unread = config.unreadProperties();
+  CHECK( unread.size() == 2 );
+  CHECK( unread[0] == "flag" && unread[1] == "scael" );
+  CHECK( config.has("flag") );
+  unread = config.unreadProperties();
+  CHECK( unread.size() == 1 && unread[0] == "scael" );
+
+  return 0;
+}
@@ -0,0 +1,519 @@
+// Regression benchmark of the event loop. Generates synthetic xAOD files,
+// runs the loop over them in each of its modes (serial, threaded, batched
+// and pipelined), and compares the event rate, the read rate and the
+// peak resident memory of every mode with stored baselines. Every mode
+// runs in a process of its own, and its jobs read the synthetic objects
+// of every event. Exits with an error if any of the numbers got worse by
+// more than the tolerance, and also if there is no baseline to compare
+// with, unless the job writes the baselines with --write-baselines.
+// The baselines depend on the machine, so measure them once on the one
+// the suite runs on.
+//
+// Usage: cp_benchmark_suite [--events N] [--files N] [--objects N]
+//          [--variables N] [--threads N] [--block-size K]
+//          [--baselines FILE] [--write-baselines FILE] [--tolerance X]
+//          [--input-dir DIR] [--keep-inputs]
+
+// System includes
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+#include "TFile.h"
+#include "TSystem.h"
+
+// Infrastructure includes
+#include "xAODRootAccess/Init.h"
+#include "xAODRootAccess/TEvent.h"
+#include "AsgTools/StatusCode.h"
+
+// EDM includes
+#include "xAODEventInfo/EventInfo.h"
+#include "xAODEventInfo/EventAuxInfo.h"
+#include "xAODJet/JetContainer.h"
+#include "xAODJet/JetAuxContainer.h"
+
+// Local includes
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/EventLoop.h"
+#include "CPTutorialExample/JsonValue.h"
+#include "CPTutorialExample/ToolStage.h"
+#include "CPTutorialExample/ContainerHandle.h"
+#include "CPTutorialExample/ForkedProcess.h"
+#include "CPTutorialExample/Check.h"
+
+// Error checking macro
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
+  } while( false )
+
+namespace {
+
+  /// Key of the generated container
+  const char* const OBJECTS_KEY = "SyntheticJets";
+
+  /// Name of a generated float variable of the objects
+  std::string variableName(unsigned int index)
+  {
+    return "synthetic" + std::to_string(index);
+  }
+
+  /// Sums float variables over the objects of a jet container
+  ///
+  /// Gives the suite's jobs the work of reading every object of every
+  /// event, as their calibration would. The sum is put on EventInfo, so
+  /// that none of it can be skipped:
+  ///
+  ///   { "type": "SyntheticSum", "name": "SyntheticSum",
+  ///     "container": "SyntheticJets",
+  ///     "properties": { "variables": [ "synthetic0", "synthetic1" ] } }
+  ///
+  class SyntheticSum : public CPTutorial::ToolStage {
+
+  public:
+    SyntheticSum() : m_input(), m_variables(), m_output() {}
+
+    virtual StatusCode initialize(const CPTutorial::ToolConfig& config)
+    {
+      const char* APP_NAME = config.name.c_str();
+      std::vector<std::string> variables;
+      CPT_RETURN_CHECK( APP_NAME, config.getStrings("variables",
+                                                    variables) );
+      m_input.reset(
+        new CPTutorial::ContainerHandle<xAOD::JetContainer>(
+          config.container));
+      m_variables.clear();
+      for(std::size_t i = 0; i < variables.size(); ++i) {
+        m_variables.push_back(FloatAccessor(variables[i]));
+      }
+      m_output.reset(new SG::AuxElement::Decorator<float>(config.name));
+      return StatusCode::SUCCESS;
+    }
+
+    virtual bool readsContainer() const { return true; }
+
+    virtual StatusCode execute(const CPTutorial::ToolContext& context)
+    {
+      const char* APP_NAME = "SyntheticSum";
+      const xAOD::JetContainer* objects = m_input->get(context.cursor);
+      CPT_RETURN_CHECK( APP_NAME, objects );
+      float sum = 0;
+      for(std::size_t v = 0; v < m_variables.size(); ++v) {
+        const FloatAccessor& variable = m_variables[v];
+        for(std::size_t i = 0; i < objects->size(); ++i) {
+          sum += variable(*(*objects)[i]);
+        }
+      }
+      (*m_output)(context.eventInfo) = sum;
+      return StatusCode::SUCCESS;
+    }
+
+  private:
+    typedef SG::AuxElement::ConstAccessor<float> FloatAccessor;
+
+    std::unique_ptr<CPTutorial::ContainerHandle<xAOD::JetContainer> >
+      m_input;
+    std::vector<FloatAccessor> m_variables;
+    std::unique_ptr<SG::AuxElement::Decorator<float> > m_output;
+
+  }; // class SyntheticSum
+
+} // private namespace
+
+CPT_REGISTER_TOOL_STAGE( SyntheticSum, "SyntheticSum" )
+
+namespace {
+
+  /// Settings of the suite
+  struct SuiteConfig {
+    /// Events per generated file
+    Long64_t events;
+    /// Number of generated files
+    unsigned int files;
+    /// Mean number of objects per event
+    unsigned int objects;
+    /// Float variables per object
+    unsigned int variables;
+    /// Threads of the threaded and pipelined modes
+    unsigned int threads;
+    /// Block size of the batched and pipelined modes
+    unsigned int blockSize;
+    /// Allowed fractional loss against the baselines
+    double tolerance;
+    std::string baselines, writeBaselines, inputDir;
+    bool keepInputs;
+  };
+
+  /// One way of running the event loop
+  struct Mode {
+    const char* name;
+    unsigned int threads, blockSize, pipelineThreads;
+  };
+
+  /// Measurements of one mode, sent back from the process running it
+  struct Measurement {
+    double eventsPerSecond, mbPerSecond, rssMB;
+  };
+
+  /// The stage reading all generated variables of the objects
+  bool objectReader(const SuiteConfig& config,
+                    CPTutorial::ToolConfig& reader)
+  {
+    const char* APP_NAME = "objectReader";
+    std::string properties = "{ \"variables\": [";
+    for(unsigned int v = 0; v < config.variables; ++v) {
+      properties += (v > 0 ? ", \"" : " \"") + variableName(v) + "\"";
+    }
+    properties += " ] }";
+    reader.type = "SyntheticSum";
+    reader.name = "SyntheticSum";
+    reader.container = OBJECTS_KEY;
+    std::string error;
+    if(!CPTutorial::JsonValue::parse(properties, reader.properties, error)) {
+      Error(APP_NAME, "Invalid properties: %s", error.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /// Read an unsigned number following an option
+  bool optionNumber(int argc, char* argv[], int& i, unsigned long long& n)
+  {
+    if(i + 1 >= argc) return false;
+    char* end = 0;
+    n = std::strtoull(argv[++i], &end, 10);
+    return *argv[i] != '\0' && *argv[i] != '-' && *end == '\0';
+  }
+
+  /// Fill the settings from the command line
+  bool parseArguments(int argc, char* argv[], SuiteConfig& config)
+  {
+    for(int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      unsigned long long n = 0;
+      if(arg == "--events" && optionNumber(argc, argv, i, n) && n > 0) {
+        config.events = n;
+      }
+      else if(arg == "--files" && optionNumber(argc, argv, i, n) && n > 0) {
+        config.files = n;
+      }
+      else if(arg == "--objects" && optionNumber(argc, argv, i, n)) {
+        config.objects = n;
+      }
+      else if(arg == "--variables" && optionNumber(argc, argv, i, n)) {
+        config.variables = n;
+      }
+      else if(arg == "--threads" && optionNumber(argc, argv, i, n) && n > 1) {
+        config.threads = n;
+      }
+      else if(arg == "--block-size" && optionNumber(argc, argv, i, n) &&
+              n > 0) {
+        config.blockSize = n;
+      }
+      else if(arg == "--tolerance" && i + 1 < argc) {
+        char* end = 0;
+        config.tolerance = std::strtod(argv[++i], &end);
+        if(*end != '\0' || config.tolerance < 0) return false;
+      }
+      else if(arg == "--baselines" && i + 1 < argc) {
+        config.baselines = argv[++i];
+      }
+      else if(arg == "--write-baselines" && i + 1 < argc) {
+        config.writeBaselines = argv[++i];
+      }
+      else if(arg == "--input-dir" && i + 1 < argc) {
+        config.inputDir = argv[++i];
+      }
+      else if(arg == "--keep-inputs") {
+        config.keepInputs = true;
+      }
+      else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Write one synthetic xAOD file
+  ///
+  /// Every event has an EventInfo, as in simulation, and a jet container
+  /// with an auxiliary store, its objects having the requested number of
+  /// float variables. The number of objects is Poisson distributed
+  /// around the requested mean.
+  bool generateFile(const std::string& fileName, const SuiteConfig& config,
+                    unsigned int fileIndex, std::mt19937& rng)
+  {
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "RECREATE"));
+    if(!file.get() || file->IsZombie()) return false;
+    xAOD::TEvent event(xAOD::TEvent::kClassAccess);
+    if(!event.writeTo(file.get()).isSuccess()) return false;
+
+    typedef SG::AuxElement::Accessor<float> FloatAccessor;
+    std::vector<FloatAccessor> variables;
+    for(unsigned int v = 0; v < config.variables; ++v) {
+      variables.push_back(FloatAccessor(variableName(v)));
+    }
+    std::poisson_distribution<unsigned int>
+      multiplicity(config.objects > 0 ? config.objects : 1);
+    std::poisson_distribution<unsigned int> pileup(30);
+    std::exponential_distribution<float> value(1. / 30.);
+
+    for(Long64_t i = 0; i < config.events; ++i) {
+      xAOD::EventInfo* info = new xAOD::EventInfo();
+      xAOD::EventAuxInfo* aux = new xAOD::EventAuxInfo();
+      info->setStore(aux);
+      info->setEventTypeBitmask(xAOD::EventInfo::IS_SIMULATION);
+      info->setRunNumber(284500);
+      info->setMCChannelNumber(410000);
+      info->setEventNumber(fileIndex * config.events + i + 1);
+      info->setLumiBlock(1 + i / 1000);
+      info->setAverageInteractionsPerCrossing(pileup(rng) + 0.5f);
+      info->setMCEventWeights(std::vector<float>(1, 1.f));
+      const unsigned int nObjects =
+        config.objects > 0 ? multiplicity(rng) : 0;
+      xAOD::JetContainer* objects = new xAOD::JetContainer();
+      xAOD::JetAuxContainer* objectsAux = new xAOD::JetAuxContainer();
+      objects->setStore(objectsAux);
+      for(unsigned int j = 0; j < nObjects; ++j) {
+        xAOD::Jet* object = new xAOD::Jet();
+        objects->push_back(object);
+        for(std::size_t v = 0; v < variables.size(); ++v) {
+          variables[v](*object) = value(rng);
+        }
+      }
+      const std::string objectsKey = OBJECTS_KEY;
+      if(!event.record(info, "EventInfo").isSuccess() ||
+         !event.record(aux, "EventInfoAux.").isSuccess() ||
+         !event.record(objects, objectsKey).isSuccess() ||
+         !event.record(objectsAux, objectsKey + "Aux.").isSuccess() ||
+         event.fill() <= 0) {
+        return false;
+      }
+    }
+    if(!event.finishWritingTo(file.get()).isSuccess()) return false;
+    file->Close();
+    return true;
+  }
+
+  /// A number of a baseline entry, or a negative value if it is unset
+  double baselineValue(const CPTutorial::JsonValue* mode, const char* key)
+  {
+    const CPTutorial::JsonValue* value = mode ? mode->member(key) : 0;
+    return (value && value->isNumber()) ? value->number() : -1.;
+  }
+
+  /// A baseline value for the comparison table, "-" if it is unset
+  std::string formatBaseline(double value, const char* format)
+  {
+    if(value < 0) return "-";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    return buffer;
+  }
+
+  /// Whether the baselines were measured with the same inputs and modes
+  bool sameSettings(const CPTutorial::JsonValue& baselines,
+                    const SuiteConfig& config)
+  {
+    const char* keys[] = { "events", "files", "objects", "variables",
+                           "threads", "block_size" };
+    const double values[] = {
+      double(config.events), double(config.files), double(config.objects),
+      double(config.variables), double(config.threads),
+      double(config.blockSize)
+    };
+    for(std::size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i) {
+      const CPTutorial::JsonValue* value = baselines.member(keys[i]);
+      if(!value || !value->isNumber() || value->number() != values[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Write the measurements as a baseline file
+  bool writeBaselines(const std::string& fileName, const SuiteConfig& config,
+                      const std::vector<Mode>& modes,
+                      const std::vector<Measurement>& results)
+  {
+    FILE* out = std::fopen(fileName.c_str(), "w");
+    if(!out) return false;
+    std::fprintf(out, "{\n  \"events\": %lli,\n  \"files\": %u,\n"
+                 "  \"objects\": %u,\n  \"variables\": %u,\n"
+                 "  \"threads\": %u,\n  \"block_size\": %u,\n"
+                 "  \"modes\": {\n", config.events, config.files,
+                 config.objects, config.variables, config.threads,
+                 config.blockSize);
+    for(std::size_t i = 0; i < modes.size(); ++i) {
+      std::fprintf(out, "    \"%s\": { \"events_per_s\": %.1f, "
+                   "\"mb_per_s\": %.2f, \"rss_mb\": %.1f }%s\n",
+                   modes[i].name, results[i].eventsPerSecond,
+                   results[i].mbPerSecond, results[i].rssMB,
+                   i + 1 < modes.size() ? "," : "");
+    }
+    std::fprintf(out, "  }\n}\n");
+    return std::fclose(out) == 0;
+  }
+
+} // private namespace
+
+int main(int argc, char* argv[])
+{
+  const char* APP_NAME = argv[0];
+
+  // The defaults give a job of a few seconds per mode
+  SuiteConfig config;
+  config.events = 20000;
+  config.files = 2;
+  config.objects = 20;
+  config.variables = 4;
+  config.threads = 4;
+  config.blockSize = 64;
+  config.tolerance = 0.15;
+  const char* rootCoreBin = std::getenv("ROOTCOREBIN");
+  config.baselines = std::string(rootCoreBin ? rootCoreBin : ".") +
+    "/data/CPTutorialExample/benchmark_baselines.json";
+  config.inputDir = "cp_benchmark_inputs";
+  config.keepInputs = false;
+  if(!parseArguments(argc, argv, config)) {
+    Error(APP_NAME, "Usage: %s [--events N] [--files N] [--objects N] "
+          "[--variables N] [--threads N] [--block-size K] [--baselines FILE] "
+          "[--write-baselines FILE] [--tolerance X] [--input-dir DIR] "
+          "[--keep-inputs]", APP_NAME);
+    return 1;
+  }
+
+  CHECK( xAOD::Init(APP_NAME) );
+  StatusCode::enableFailure();
+
+  // Generate the inputs
+  gSystem->mkdir(config.inputDir.c_str(), kTRUE);
+  std::vector<std::string> files;
+  std::mt19937 rng(12345);
+  for(unsigned int i = 0; i < config.files; ++i) {
+    files.push_back(config.inputDir + "/synthetic_" + std::to_string(i) +
+                    ".root");
+    CHECK( generateFile(files.back(), config, i, rng) );
+  }
+  Info(APP_NAME, "Generated %u files of %lli events with %u objects of %u "
+       "variables on average", config.files, config.events, config.objects,
+       config.variables);
+
+  // Run the modes one after the other on the same input, which the first
+  // run brings into the page cache. Each of them runs in a process of its
+  // own, so that its peak memory is its own.
+  std::vector<Mode> modes;
+  const Mode serial = { "serial", 1, 1, 0 };
+  const Mode threaded = { "threaded", config.threads, 1, 0 };
+  const Mode batched = { "batched", 1, config.blockSize, 0 };
+  const Mode pipelined = { "pipelined", 1, config.blockSize, config.threads };
+  modes.push_back(serial);
+  modes.push_back(threaded);
+  modes.push_back(batched);
+  modes.push_back(pipelined);
+  CPTutorial::ToolConfig reader;
+  CHECK( objectReader(config, reader) );
+  std::vector<Measurement> results;
+  for(std::size_t i = 0; i < modes.size(); ++i) {
+    CPTutorial::JobConfig job;
+    job.inputFiles = files;
+    job.nThreads = modes[i].threads;
+    job.blockSize = modes[i].blockSize;
+    job.pipelineThreads = modes[i].pipelineThreads;
+    job.progressEvery = 0;
+    job.progressInterval = 0;
+    job.tools.push_back(reader);
+    job.readCache.branches.push_back(OBJECTS_KEY);
+    Info(APP_NAME, "Running in %s mode", modes[i].name);
+    Measurement m = { 0, 0, 0 };
+    const auto run = [&job, &m]() -> StatusCode {
+      CPTutorial::EventLoop loop(job);
+      if(!loop.run().isSuccess()) return StatusCode::FAILURE;
+      const double wallTime = loop.wallTime() > 0 ? loop.wallTime() : 1e-9;
+      m.eventsPerSecond = loop.result().nProcessed / wallTime;
+      m.mbPerSecond = loop.result().readStats.bytesRead / 1048576. / wallTime;
+      return StatusCode::SUCCESS;
+    };
+    CHECK( CPTutorial::runForked(run, &m, sizeof(m), &m.rssMB).isSuccess() );
+    results.push_back(m);
+  }
+
+  if(!config.keepInputs) {
+    for(std::size_t i = 0; i < files.size(); ++i) {
+      gSystem->Unlink(files[i].c_str());
+    }
+  }
+  if(!config.writeBaselines.empty()) {
+    CHECK( writeBaselines(config.writeBaselines, config, modes, results) );
+    Info(APP_NAME, "Baselines written to %s", config.writeBaselines.c_str());
+  }
+
+  // Compare with the baselines, if they were measured on the same inputs.
+  // Without them a regression can't be seen, which is an error unless
+  // this job makes new ones.
+  const bool writing = !config.writeBaselines.empty();
+  CPTutorial::JsonValue baselines;
+  bool compare = CPTutorial::JsonValue::readFile(config.baselines, baselines);
+  if(compare && !sameSettings(baselines, config)) {
+    if(!writing) {
+      Error(APP_NAME, "The baselines of %s were measured with other "
+            "settings", config.baselines.c_str());
+      return 1;
+    }
+    Warning(APP_NAME, "The baselines of %s were measured with other "
+            "settings, not comparing", config.baselines.c_str());
+    compare = false;
+  }
+  const CPTutorial::JsonValue* baselineModes =
+    compare ? baselines.member("modes") : 0;
+  Info(APP_NAME, "%-10s %12s %12s %10s %10s %9s %9s", "mode", "events/s",
+       "baseline", "MB/s", "baseline", "peak RSS", "baseline");
+  unsigned int nRegressions = 0, nMissing = 0;
+  for(std::size_t i = 0; i < modes.size(); ++i) {
+    const Measurement& m = results[i];
+    const CPTutorial::JsonValue* b =
+      baselineModes ? baselineModes->member(modes[i].name) : 0;
+    const double bEvents = baselineValue(b, "events_per_s");
+    const double bMB = baselineValue(b, "mb_per_s");
+    const double bRss = baselineValue(b, "rss_mb");
+    // Rates may not drop, the memory may not grow, beyond the tolerance
+    const bool slower =
+      (bEvents > 0 && m.eventsPerSecond < bEvents * (1 - config.tolerance)) ||
+      (bMB > 0 && m.mbPerSecond < bMB * (1 - config.tolerance));
+    const bool bigger = (bRss > 0 && m.rssMB > bRss * (1 + config.tolerance));
+    Info(APP_NAME, "%-10s %12.1f %12s %10.2f %10s %9.1f %9s%s",
+         modes[i].name, m.eventsPerSecond,
+         formatBaseline(bEvents, "%.1f").c_str(), m.mbPerSecond,
+         formatBaseline(bMB, "%.2f").c_str(), m.rssMB,
+         formatBaseline(bRss, "%.1f").c_str(),
+         (slower || bigger) ? "  REGRESSION" : "");
+    if(slower || bigger) ++nRegressions;
+    if(bEvents < 0 || bMB < 0 || bRss < 0) ++nMissing;
+  }
+  if(nMissing > 0 && !writing) {
+    Error(APP_NAME, "%u of %u modes have no baseline in %s. Measure them "
+          "on this machine with --write-baselines.", nMissing,
+          static_cast<unsigned int>(modes.size()), config.baselines.c_str());
+    return 1;
+  }
+  if(nRegressions > 0) {
+    Error(APP_NAME, "%u of %u modes regressed by more than %.0f%%",
+          nRegressions, static_cast<unsigned int>(modes.size()),
+          100. * config.tolerance);
+    return 1;
+  }
+
+  Info(APP_NAME, "Application finished");
+  return EXIT_SUCCESS;
+}
@@ -3,27 +3,29 @@
 // author: Steve Farrell <Steven.Farrell@cern.ch>
 
 // ROOT includes
-#include "TFile.h"
 #include "TError.h"
 
 // Infrastructure includes
 #include "xAODRootAccess/Init.h"
-#include "xAODRootAccess/TEvent.h"
-#include "xAODRootAccess/TStore.h"
 #include "AsgTools/StatusCode.h"
 
-// EDM includes
-#include "xAODEventInfo/EventInfo.h"
+// Local includes
+#include "CPTutorialExample/JobConfig.h"
+#include "CPTutorialExample/EventLoop.h"
+#include "CPTutorialExample/AccessModeComparison.h"
+#include "CPTutorialExample/BlockSizeScan.h"
+#include "CPTutorialExample/StartupTimer.h"
+#include "CPTutorialExample/Check.h"
 
 // Error checking macro
-#define CHECK( ARG )                                 \
-  do {                                               \
-    const bool result = ARG;                         \
-    if(!result) {                                    \
-      ::Error(APP_NAME, "Failed to execute: \"%s\"", \
-              #ARG );                                \
-      return 1;                                      \
-    }                                                \
+#define CHECK( ARG )                                                \
+  do {                                                              \
+    const bool result = ARG;                                        \
+    if(CPT_UNLIKELY(!result)) {                                     \
+      ::CPTutorial::reportCheckFailure(APP_NAME, #ARG, __FILE__,    \
+                                       __LINE__);                   \
+      return 1;                                                     \
+    }                                                               \
   } while( false )
 
 // Our main function
@@ -31,58 +33,41 @@ int main(int argc, char* argv[])
 {
   // The application's name
   const char* APP_NAME = argv[0];
+  CPTutorial::StartupTimer startup;
 
-  // Check if we received a file name
-  if(argc < 2) {
-    Error( APP_NAME, "No file name received!" );
-    Error( APP_NAME, "  Usage: %s [xAOD file name]", APP_NAME );
-    return 1;
+  // Parse the command line
+  CPTutorial::JobConfig config;
+  if(!config.parse(argc, argv) || config.showHelp) {
+    CPTutorial::JobConfig::printUsage(APP_NAME);
+    return config.showHelp ? EXIT_SUCCESS : 1;
   }
+  startup.mark("Command line");
 
   // Initialise the application
   CHECK( xAOD::Init(APP_NAME) );
   StatusCode::enableFailure();
+  startup.mark("xAOD::Init");
 
-  // Open the input file
-  const char* fileName = argv[1];
-  Info(APP_NAME, "Opening file: %s", fileName);
-  std::unique_ptr<TFile> file(TFile::Open(fileName));
-  CHECK( file.get() );
-
-  // Create a TEvent object
-  xAOD::TEvent event;
-  CHECK( event.readFrom(file.get()) );
-  Info(APP_NAME, "Number of events in the file: %lli", event.getEntries());
-
-  // Create a transient store
-  xAOD::TStore store;
-
-
-
-  // @@@ Create and configure your CP tools here @@@ //
-
-
-
-  // Loop over events
-  Long64_t nEntries = event.getEntries();
-  nEntries = std::min(nEntries, 20ll); // Remove this to run all events
-  for(Long64_t entry = 0; entry < nEntries; ++entry)
-  {
-    // Tell TEvent which entry to use
-    event.getEntry(entry);
-
-    // Retrieve and print basic event information
-    const xAOD::EventInfo* evtInfo = 0;
-    CHECK( event.retrieve(evtInfo, "EventInfo") );
-    Info(APP_NAME,
-         "===>>> Processing event #%lli, "
-         "run #%u, %lli events processed so far  <<<===",
-         evtInfo->eventNumber(), evtInfo->runNumber(), entry);
+  // Compare the TEvent access modes if requested
+  if(config.compareAccessModes) {
+    CHECK( CPTutorial::compareAccessModes(config).isSuccess() );
+    Info(APP_NAME, "Application finished");
+    return EXIT_SUCCESS;
+  }
 
-    // Clear the transient store
-    store.clear();
+  // Find the fastest block size if requested
+  if(!config.blockSizeScan.empty()) {
+    CHECK( CPTutorial::scanBlockSizes(config).isSuccess() );
+    Info(APP_NAME, "Application finished");
+    return EXIT_SUCCESS;
   }
 
+  // Run the event loop. The input file, the TEvent/TStore objects and the
+  // CP tools are set up per worker, see EventWorker::initialize().
+  CPTutorial::EventLoop loop(config);
+  loop.setStartupTimer(&startup);
+  CHECK( loop.run().isSuccess() );
+
   // Closing message
   Info(APP_NAME, "Application finished");
 
@@ -0,0 +1,133 @@
+// Microbenchmark of the good-run list lookup of GoodRunsList, against a
+// linear search through the lumiblock ranges as read from the XML file.
+//
+// Usage: grl_benchmark [lookups]
+
+// System includes
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// ROOT includes
+#include "TError.h"
+
+// Local includes
+#include "CPTutorialExample/GoodRunsList.h"
+
+namespace {
+
+  /// A lumiblock range, as listed in a GRL file
+  struct LBRange {
+    UInt_t run, firstLB, lastLB;
+  };
+
+  /// An event to look up
+  struct Query {
+    UInt_t run, lumiBlock;
+  };
+
+  /// The straightforward check: scan all ranges
+  bool linearAccept(const std::vector<LBRange>& ranges, UInt_t run,
+                    UInt_t lumiBlock)
+  {
+    for(std::size_t i = 0; i < ranges.size(); ++i) {
+      const LBRange& r = ranges[i];
+      if(r.run == run && lumiBlock >= r.firstLB && lumiBlock <= r.lastLB) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Time a lookup function over all queries [ns/lookup]
+  template<typename FUNC>
+  double timeLookups(const std::vector<Query>& queries, FUNC accept,
+                     unsigned long long& nGood)
+  {
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    nGood = 0;
+    for(std::size_t i = 0; i < queries.size(); ++i) {
+      nGood += accept(queries[i].run, queries[i].lumiBlock);
+    }
+    return 1e9 * std::chrono::duration<double>(clock::now() - start).count()
+      / queries.size();
+  }
+
+} // private namespace
+
+int main(int argc, char* argv[])
+{
+  const char* APP_NAME = argv[0];
+  const std::size_t nQueries =
+    argc > 1 ? std::strtoul(argv[1], 0, 10) : 10000000;
+  if(nQueries == 0) {
+    Error(APP_NAME, "Usage: %s [lookups]", APP_NAME);
+    return 1;
+  }
+
+  // A year's worth of runs with a few good ranges each
+  std::mt19937 rng(12345);
+  std::vector<LBRange> ranges;
+  CPTutorial::GoodRunsList grl;
+  const UInt_t nRuns = 400, maxLB = 1500;
+  for(UInt_t i = 0; i < nRuns; ++i) {
+    const UInt_t run = 276000 + 37 * i;
+    UInt_t lb = 1 + rng() % 20;
+    while(lb < maxLB) {
+      const UInt_t length = 1 + rng() % 300;
+      LBRange r = { run, lb, lb + length - 1 };
+      ranges.push_back(r);
+      grl.addRange(r.run, r.firstLB, r.lastLB);
+      lb += length + 1 + rng() % 30;
+    }
+  }
+  grl.compile();
+  Info(APP_NAME, "GRL of %u runs in %u ranges",
+       static_cast<unsigned int>(grl.nRuns()),
+       static_cast<unsigned int>(ranges.size()));
+
+  // Events as they come in a data file: ordered by run and lumiblock,
+  // and shuffled, for the worst case of the run cache
+  std::vector<Query> ordered(nQueries);
+  const std::size_t perRun = std::max<std::size_t>(1, nQueries / nRuns);
+  for(std::size_t i = 0; i < nQueries; ++i) {
+    ordered[i].run = 276000 + 37 * UInt_t(std::min<std::size_t>(
+      i / perRun, nRuns - 1));
+    ordered[i].lumiBlock = 1 + UInt_t((i % perRun) * maxLB / perRun);
+  }
+  std::vector<Query> shuffled = ordered;
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+  const std::vector<Query>* samples[] = { &ordered, &shuffled };
+  const char* names[] = { "ordered", "shuffled" };
+  for(int s = 0; s < 2; ++s) {
+    unsigned long long goodBitmap = 0, goodLinear = 0;
+    const double tBitmap = timeLookups(*samples[s],
+      [&grl](UInt_t run, UInt_t lb) { return grl.accept(run, lb); },
+      goodBitmap);
+    // The linear search is slow, only time a part of the sample
+    std::vector<Query> part(samples[s]->begin(), samples[s]->begin() +
+                            std::min<std::size_t>(nQueries, 100000));
+    const double tLinear = timeLookups(part,
+      [&ranges](UInt_t run, UInt_t lb) {
+        return linearAccept(ranges, run, lb); },
+      goodLinear);
+    unsigned long long check = 0;
+    timeLookups(part,
+      [&grl](UInt_t run, UInt_t lb) { return grl.accept(run, lb); },
+      check);
+    if(check != goodLinear) {
+      Error(APP_NAME, "The lookups disagree: %llu vs %llu good events",
+            check, goodLinear);
+      return 1;
+    }
+    Info(APP_NAME, "%-8s events: bitmap %7.2f ns/lookup, linear %9.2f "
+         "ns/lookup, %.1f%% good", names[s], tBitmap, tLinear,
+         100. * goodBitmap / nQueries);
+  }
+
+  return EXIT_SUCCESS;
+}